@@ -73,13 +73,26 @@ namespace logoprism {
         ("input-file,i", option< std::string >("input.file"), "input files")
         ("input-format", option< std::string >("input.format"), "input format")
         ("input-speed", option< double >("input.speed")->default_value(1.0), "input speed")
+        ("input-max-speed", option< double >("input.max-speed")->default_value(1000.0), "maximum input speed")
         ("input-keepalive", option< double >("input.keepalive")->default_value(5.0), "input keep-alive time")
+        ("input-idle-gap", option< size_t >("input.idle-gap-s")->default_value(60), "skip idle gaps longer than this (s), 0 to disable")
+        ("input-checkpoint-interval", option< size_t >("input.checkpoint-interval-s")->default_value(60), "simulated time between rewind checkpoints (s)")
+        ("input-read-ahead", option< size_t >("input.read-ahead-mb")->default_value(256), "memory budget for the requests read ahead (MB)")
+        ("input-startup-window", option< size_t >("input.startup-window-ms")->default_value(100), "simulated time read ahead before the first frame (ms)")
         ("display-width,w", option< size_t >("display.width")->default_value(1024), "display width")
         ("display-height,h", option< size_t >("display.height")->default_value(560), "display height")
         ("display-fullscreen,f", option< bool >("display.fullscreen")->default_value(false)->zero_tokens(), "run full screen")
         ("display-multisampling", option< bool >("display.multisampling")->default_value(false)->zero_tokens(), "use multisampling")
+        ("display-lod-budget", option< size_t >("display.lod-budget")->default_value(2000), "requests drawn individually before bundling them, 0 to disable")
+        ("display-cairo-tiles", option< size_t >("display.cairo-tiles")->default_value(0), "horizontal tiles drawn in parallel by the cairo renderer, 0 for one per thread")
+        ("display-curve-tolerance", option< double >("display.curve-tolerance")->default_value(0.25), "maximum distance between the curves and their tessellation (px)")
+        ("display-curve-vertex-budget", option< size_t >("display.curve-vertex-budget")->default_value(262144), "curve vertices per frame before coarsening the tessellation")
+        ("display-async-text", option< bool >("display.async-text")->default_value(true), "rasterize the OpenGL text glyphs in a background thread")
+        ("display-text-cache", option< size_t >("display.text-cache-mb")->default_value(32), "memory budget of the renderer text cache (MB)")
+        ("display-threads", option< size_t >("display.threads")->default_value(0), "view update threads, 0 for one less than the hardware threads")
         ("output-video,o", option< bool >("output.video")->default_value(false)->zero_tokens(), "encode video")
         ("output-framerate", option< size_t >("output.framerate"), "output frame rate (fps)")
+        ("output-readback-frames", option< size_t >("output.readback-frames")->default_value(3), "frames read back at once by the OpenGL renderer, each frame being encoded that many frames minus one later, 0 to read synchronously")
         ("output-pipeline", option< std::string >("output.pipeline"), "output gstreamer pipeline");
 
       bpo::options_description command_line_options;
@@ -0,0 +1,90 @@
+#ifndef __LOGOPRISM_DATA_CHECKPOINT_STORE_HPP__
+#define __LOGOPRISM_DATA_CHECKPOINT_STORE_HPP__
+
+#include "logoprism/data/datetime.hpp"
+
+#include <map>
+
+namespace logoprism {
+  namespace data {
+
+    /**
+     * Bounded store of periodic state checkpoints, keyed by simulated time.
+     *
+     * When the store is full, every other checkpoint is discarded and the checkpoint interval is doubled, so that the
+     * whole simulated time range stays covered with a bounded memory usage.
+     */
+    template< typename T >
+    struct checkpoint_store {
+      public:
+        /**
+         * Creates a new checkpoint store.
+         * @param interval the minimum simulated time between two checkpoints
+         * @param capacity the maximum number of checkpoints to keep
+         */
+        checkpoint_store(data::duration const& interval, size_t const capacity) :
+          interval(interval),
+          capacity(std::max< size_t >(capacity, 2))
+        {}
+
+        /** whether a new checkpoint should be taken at the given simulated time */
+        bool due(data::datetime const& time) const {
+          return this->checkpoints.empty() || (time >= this->checkpoints.rbegin()->first + this->interval);
+        }
+
+        /** stores a checkpoint of the state at the given simulated time */
+        void insert(data::datetime const& time, T const& checkpoint) {
+          this->checkpoints[time] = checkpoint;
+
+          if (this->checkpoints.size() > this->capacity)
+            this->thin();
+        }
+
+        /**
+         * Finds the latest checkpoint taken at or before the given simulated time.
+         * @param  time            the simulated time to look for
+         * @param  checkpoint_time the simulated time of the checkpoint found
+         * @param  checkpoint      the checkpoint found
+         * @return                 whether a checkpoint has been found
+         */
+        bool nearest(data::datetime const& time, data::datetime& checkpoint_time, T& checkpoint) const {
+          auto it = this->checkpoints.upper_bound(time);
+          if (it == this->checkpoints.begin())
+            return false;
+
+          --it;
+          checkpoint_time = it->first;
+          checkpoint      = it->second;
+          return true;
+        }
+
+        size_t size() const { return this->checkpoints.size(); }
+        void   clear() { this->checkpoints.clear(); }
+
+      protected:
+        data::duration                interval;
+        size_t const                  capacity;
+        std::map< data::datetime, T > checkpoints;
+
+        /** discards every other checkpoint, keeping the first and the last ones, and doubles the interval */
+        void thin() {
+          auto const last = std::prev(this->checkpoints.end());
+
+          bool keep = true;
+          for (auto it = this->checkpoints.begin(); it != last;) {
+            if (keep)
+              ++it;
+            else
+              this->checkpoints.erase(it++);
+
+            keep = !keep;
+          }
+
+          this->interval *= 2;
+        }
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_DATA_CHECKPOINT_STORE_HPP__
@@ -61,6 +61,9 @@ namespace logoprism {
 
       /** the system time to skip at next simulation time calculation */
       data::duration skip_timelapse;
+
+      /** the total simulated time skipped by the simulator, as of this tick */
+      data::duration simulation_skipped;
     };
 
     template< typename T >
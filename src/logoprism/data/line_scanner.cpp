@@ -0,0 +1,153 @@
+#include "logoprism/data/line_scanner.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define LOGOPRISM_LINE_SCANNER_SSE2
+# include <emmintrin.h>
+#endif // if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+namespace logoprism {
+  namespace data {
+
+    namespace {
+      namespace bio = boost::iostreams;
+
+      /** size of the file chunks mapped at once while scanning */
+      static uint64_t const chunk_size = static_cast< uint64_t >(64) << 20;
+
+      /** size of the head and tail of the file mapped when sampling lines */
+      static uint64_t const sample_size = static_cast< uint64_t >(64) << 10;
+    }
+
+    /** functor to hold the scanning thread */
+    struct line_scanner_thread {
+      line_scanner_thread(line_scanner* scanner) :
+        scanner(scanner)
+      {}
+
+      void operator()() {
+        try {
+          scanner->run();
+        } catch (std::exception const& e) {
+          std::clog << "E: unable to scan " << scanner->filename << ": " << e.what() << std::endl;
+        }
+
+        scanner->scan_finished = true;
+      }
+
+      line_scanner* scanner;
+    };
+
+    line_scanner::line_scanner(std::string const& filename, size_t const sample_lines) :
+      filename(filename),
+      sample_lines(sample_lines),
+      size(boost::filesystem::exists(filename) ? boost::filesystem::file_size(filename) : 0),
+      scanned(0),
+      lines(0),
+      scan_finished(false),
+      scanning_thread()
+    {}
+
+    line_scanner::~line_scanner() {
+      this->stop();
+    }
+
+    void line_scanner::start() {
+      this->scanning_thread = boost::thread(line_scanner_thread(this));
+    }
+
+    void line_scanner::stop() {
+      if (this->scanning_thread.joinable()) {
+        this->scanning_thread.interrupt();
+        this->scanning_thread.join();
+      }
+    }
+
+    uint64_t line_scanner::count_newlines(char const* const data, size_t const size) {
+      uint64_t count = 0;
+      size_t   i     = 0;
+
+#ifdef LOGOPRISM_LINE_SCANNER_SSE2
+      __m128i const newline = _mm_set1_epi8('\n');
+      __m128i const zero    = _mm_setzero_si128();
+
+      // compare 16 bytes at a time and accumulate the matches as per-byte counters, which have to be
+      // summed before they overflow, ie: at most every 255 iterations
+      while (i + 16 <= size) {
+        __m128i      counters = _mm_setzero_si128();
+        size_t const end      = std::min(size - size % 16, i + 255 * 16);
+
+        for (; i < end; i += 16) {
+          __m128i const bytes = _mm_loadu_si128(reinterpret_cast< __m128i const* >(data + i));
+          counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(bytes, newline));
+        }
+
+        __m128i const sums = _mm_sad_epu8(counters, zero);
+        count += static_cast< uint64_t >(_mm_cvtsi128_si32(sums)) + static_cast< uint64_t >(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+      }
+#endif // ifdef LOGOPRISM_LINE_SCANNER_SSE2
+
+      return count + std::count(data + i, data + size, '\n');
+    }
+
+    void line_scanner::run() {
+      if (this->size == 0)
+        return;
+
+      // keep some lines from the head of the file, the last one may be truncated
+      {
+        bio::mapped_file_source source(this->filename, std::min(this->size, sample_size), 0);
+        std::string const       data(source.data(), source.size());
+        boost::split(this->head, data, boost::is_any_of("\n"));
+
+        if (this->head.size() > 1)
+          this->head.pop_back();
+        if (this->head.size() > this->sample_lines)
+          this->head.resize(this->sample_lines);
+      }
+
+      // map the file chunk by chunk and count the newlines
+      bool last_line_ended = false;
+      for (uint64_t offset = 0; offset < this->size; offset += chunk_size) {
+        boost::this_thread::interruption_point();
+
+        bio::mapped_file_source source(this->filename, std::min(this->size - offset, chunk_size), offset);
+
+        this->lines   += line_scanner::count_newlines(source.data(), source.size());
+        this->scanned += source.size();
+
+        last_line_ended = source.data()[source.size() - 1] == '\n';
+      }
+
+      // the last line may not end with a newline
+      if (!last_line_ended)
+        this->lines += 1;
+
+      // keep some lines from the tail of the file, the first one may be truncated
+      {
+        uint64_t const tail_size   = std::min(this->size, sample_size);
+        uint64_t const tail_offset = (this->size - tail_size) / bio::mapped_file_source::alignment() * bio::mapped_file_source::alignment();
+
+        bio::mapped_file_source source(this->filename, this->size - tail_offset, tail_offset);
+        std::string const       data(source.data(), source.size());
+        boost::split(this->tail, data, boost::is_any_of("\n"));
+
+        while (!this->tail.empty() && this->tail.back().empty())
+          this->tail.pop_back();
+        if ((tail_offset > 0) && (this->tail.size() > 1))
+          this->tail.erase(this->tail.begin());
+        if (this->tail.size() > this->sample_lines)
+          this->tail.erase(this->tail.begin(), this->tail.end() - this->sample_lines);
+      }
+
+      std::clog << "I: scanned " << this->lines << " lines in " << this->filename << std::endl;
+    }
+
+  }
+}
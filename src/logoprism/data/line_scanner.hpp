@@ -0,0 +1,82 @@
+#ifndef __LOGOPRISM_DATA_LINE_SCANNER_HPP__
+#define __LOGOPRISM_DATA_LINE_SCANNER_HPP__
+
+#include <boost/thread.hpp>
+
+#include <atomic>
+#include <vector>
+#include <string>
+
+namespace logoprism {
+  namespace data {
+
+    /**
+     * Background pre-scan of a log file, counting its lines at memory bandwidth by searching for newlines
+     * in mapped chunks of the file, and keeping a few lines from its head and tail so that the first and
+     * last timestamps can be sampled by the request parser.
+     */
+    struct line_scanner {
+      public:
+        /**
+         * Creates a new line scanner.
+         * @param filename     the log file name to scan
+         * @param sample_lines how many lines to keep from the head and the tail of the file
+         */
+        line_scanner(std::string const& filename, size_t const sample_lines=16);
+        ~line_scanner();
+
+        /** starts the scanning thread */
+        void start();
+
+        /** stops the scanning thread, waiting for it to terminate */
+        void stop();
+
+        /** whether the whole file has been scanned */
+        bool finished() const { return this->scan_finished; }
+
+        /** the size of the file, in bytes */
+        uint64_t file_size() const { return this->size; }
+
+        /** the number of bytes scanned so far */
+        uint64_t scanned_bytes() const { return this->scanned; }
+
+        /** the number of lines found so far, or in the whole file once finished */
+        uint64_t line_count() const { return this->lines; }
+
+        /** the first lines of the file, only valid once finished */
+        std::vector< std::string > const& head_lines() const { return this->head; }
+
+        /** the last lines of the file, only valid once finished */
+        std::vector< std::string > const& tail_lines() const { return this->tail; }
+
+        /**
+         * Counts the newline characters in the given memory range, using SSE2 when available.
+         * @param  data the memory to search
+         * @param  size the size of the memory to search
+         * @return      the number of '\n' found
+         */
+        static uint64_t count_newlines(char const* const data, size_t const size);
+
+      protected:
+        friend struct line_scanner_thread;
+
+        std::string const filename;
+        size_t const      sample_lines;
+        uint64_t          size;
+
+        std::atomic< uint64_t > scanned;
+        std::atomic< uint64_t > lines;
+        std::atomic< bool >     scan_finished;
+
+        std::vector< std::string > head;
+        std::vector< std::string > tail;
+
+        boost::thread scanning_thread;
+
+        void run();
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_DATA_LINE_SCANNER_HPP__
@@ -23,12 +23,59 @@ namespace logoprism {
       reader_base* reader;
     };
 
+    /** functor to hold the keyframe preparation thread */
+    struct request_keyframe_thread {
+      request_keyframe_thread(reader_base* reader) :
+        reader(reader)
+      {}
+
+      void operator()() {
+        try {
+          reader->prepare_keyframes();
+        } catch (boost::thread_interrupted const&) {}
+      }
+
+      reader_base* reader;
+    };
+
+    namespace {
+      /** how many requests are observed before the oldest out-of-order distance is forgotten */
+      static size_t const out_of_order_window = 100000;
+
+      /** estimated memory used by a request held in the read-ahead set or in the ringbuffer */
+      static uint64_t footprint(data::request const& request) {
+        // the set node holds the request and three pointers plus the color, the strings may be allocated on the heap
+        return sizeof(data::request) + 4 * sizeof(void*)
+               + request.source.size() + request.target.size() + request.status.size() + request.worker.size();
+      }
+    }
+
     reader_base::reader_base(std::string const& filename, data::simulator& simulator, data::duration const& read_margin, data::duration const& visible_margin) :
       simulator(simulator),
-      read_margin(read_margin),
+      max_read_margin(std::max(read_margin, visible_margin)),
+      read_margin(visible_margin),
       visible_margin(visible_margin),
+      idle_gap_threshold(data::seconds(static_cast< long >(config::get("input.idle-gap-s", 60)))),
+      read_ahead_budget(static_cast< uint64_t >(config::get("input.read-ahead-mb", 256)) << 20),
+      startup_window(data::milliseconds(static_cast< long >(config::get("input.startup-window-ms", 100)))),
       filestream(filename),
+      line_scanner(filename),
       worker_simulator(50),
+      checkpoints(data::seconds(static_cast< long >(config::get("input.checkpoint-interval-s", 60))), 1024),
+      read_bytes(0),
+      read_lines(0),
+      coverage_sampled(false),
+      first_time(data::not_a_date_time),
+      last_time(data::not_a_date_time),
+      read_ahead_bytes(0),
+      out_of_order_us(0),
+      read_margin_us(visible_margin.total_microseconds()),
+      latest_start_time(data::not_a_date_time),
+      out_of_order_count(0),
+      keyframe_time(data::not_a_date_time),
+      keyframe_requested(false),
+      keyframe_prepared(false),
+      keyframe_generation(0),
       reading_thread_running(false),
       reading_thread()
     {}
@@ -36,8 +83,14 @@ namespace logoprism {
     reader_base::~reader_base() {}
 
     void reader_base::stop() {
+      this->line_scanner.stop();
       this->filestream.close();
 
+      if (this->keyframe_thread.joinable()) {
+        this->keyframe_thread.interrupt();
+        this->keyframe_thread.join();
+      }
+
       if (this->reading_thread_running) {
         this->reading_thread.interrupt();
         this->reading_thread.join();
@@ -48,28 +101,85 @@ namespace logoprism {
       data::request request;
 
       // find the next valid request, reading lines one by one and parsing them
+      uint64_t offset;
+      uint64_t lines;
       do {
         if (!this->filestream.good())
           throw std::out_of_range("end of file");
 
+        boost::this_thread::interruption_point();
+
+        offset = this->read_bytes;
+        lines  = this->read_lines;
+
         std::string line;
         std::getline(this->filestream, line);
         request = this->parse(line);
+
+        this->read_bytes += line.size() + 1;
+        this->read_lines += 1;
       } while (!request.valid);
 
+      // keep the reading state from time to time, before the worker simulator handles the request
+      if (this->checkpoints.due(request.start_time)) {
+        data::reader_checkpoint checkpoint = { offset, lines, this->worker_simulator };
+
+        boost::lock_guard< boost::mutex > lock(this->checkpoints_mutex);
+        this->checkpoints.insert(request.start_time, checkpoint);
+      }
+
       // complete the request information using the worker simulator
       this->worker_simulator.handle_request(request);
 
       return request;
     }
 
+    void reader_base::sample_coverage() {
+      // parse the first and last lines of the file, without going through the worker simulator
+      for (auto const& line : this->line_scanner.head_lines()) {
+        data::request const request = this->parse(line);
+        if (request.valid && (this->first_time.is_not_a_date_time() || request.start_time < this->first_time))
+          this->first_time = request.start_time;
+      }
+
+      for (auto const& line : this->line_scanner.tail_lines()) {
+        data::request const request = this->parse(line);
+        if (request.valid && (this->last_time.is_not_a_date_time() || request.start_time + request.duration > this->last_time))
+          this->last_time = request.start_time + request.duration;
+      }
+
+      this->coverage_sampled = true;
+
+      if (this->first_time.is_not_a_date_time() || this->last_time.is_not_a_date_time() || (this->last_time <= this->first_time))
+        return;
+
+      // cap the read margin so that the requests read ahead fit in the memory budget, given the measured line rate
+      // and the average line length as an estimate of the request strings length
+      double const         lines_per_second  = this->line_scanner.line_count() / data::floating_seconds(this->last_time - this->first_time);
+      double const         bytes_per_line    = static_cast< double >(this->line_scanner.file_size()) / this->line_scanner.line_count();
+      double const         bytes_per_request = sizeof(data::request) + 4 * sizeof(void*) + bytes_per_line;
+      data::duration const budget_margin     = data::microseconds(static_cast< int64_t >(this->read_ahead_budget / bytes_per_request / lines_per_second * 1000000));
+
+      this->max_read_margin = std::max(this->visible_margin, std::min(this->max_read_margin, budget_margin));
+
+      std::clog << "I: " << lines_per_second << " lines per second from " << this->first_time << " to " << this->last_time
+                << ", maximum read margin set to " << this->max_read_margin << std::endl;
+    }
+
     void reader_base::start() {
+      this->line_scanner.start();
+      this->start_reading();
+      this->keyframe_thread = boost::thread(request_keyframe_thread(this));
+    }
+
+    void reader_base::start_reading() {
       this->reading_thread         = boost::thread(request_reader_thread(this));
       this->reading_thread_running = true;
     }
 
     data::requests::iterator reader_base::push(data::requests const& requests) {
-      std::clog << "pushing " << requests.size() << " requests" << std::endl;
+      std::clog << "pushing " << requests.size() << " requests, " << (this->read_ahead_bytes >> 20) << "MB read ahead, margin "
+                << this->read_margin << ", out of order " << data::microseconds(this->out_of_order_us.load()) << std::endl;
 
       // push as much requests as possible to the ringbuffer and return an interator to where we stopped
       for (auto pushed = requests.begin(), end = requests.end(); pushed != end; ++pushed) {
@@ -80,37 +190,91 @@ namespace logoprism {
       return requests.end();
     }
 
+    void reader_base::insert(data::requests& requests, data::request const& request) {
+      if (!requests.insert(request).second)
+        return;
+
+      this->read_ahead_bytes += footprint(request);
+
+      // track how far back in time the requests are logged, over the last two windows of requests
+      if (this->latest_start_time.is_not_a_date_time() || (request.start_time > this->latest_start_time))
+        this->latest_start_time = request.start_time;
+      else
+        this->out_of_order_windows[0] = std::max(this->out_of_order_windows[0], this->latest_start_time - request.start_time);
+
+      if (++this->out_of_order_count >= out_of_order_window) {
+        this->out_of_order_windows[1] = this->out_of_order_windows[0];
+        this->out_of_order_windows[0] = data::microseconds(0);
+        this->out_of_order_count      = 0;
+      }
+
+      this->out_of_order_us = std::max(this->out_of_order_windows[0], this->out_of_order_windows[1]).total_microseconds();
+    }
+
+    void reader_base::adapt_read_margin() {
+      // read far enough to sort the requests logged out of order before they become visible, twice the observed distance
+      // to leave some slack, but not further than the maximum read margin
+      data::duration const out_of_order = data::microseconds(this->out_of_order_us.load());
+
+      this->read_margin    = std::min(this->max_read_margin, this->visible_margin + out_of_order * 2);
+      this->read_margin_us = this->read_margin.total_microseconds();
+    }
+
     void reader_base::run() {
-      data::requests requests;
+      data::datetime const started_at = data::clock::local_time();
+      bool                 first_push = true;
+      data::requests       requests;
 
       // parse the first valid request
-      auto pair = requests.insert(this->next());
+      this->insert(requests, this->next());
 
       // set the simulator' reference time to the start time of the first request parsed
-      this->simulator.set_simulation_reference_time(pair.first->start_time);
+      this->simulator.set_simulation_reference_time(requests.begin()->start_time);
+
+      // at startup, only read a small window ahead so that the first requests are pushed right away, and grow it
+      // geometrically until it reaches the read margin
+      data::duration window = this->startup_window;
 
       data::timings timings;
       do {
         if (boost::this_thread::interruption_requested())
           return;
 
+        if (!this->coverage_sampled && this->line_scanner.finished())
+          this->sample_coverage();
+
         timings = this->simulator.timings(timings);
-        data::date_margins const& margins = this->read_margins(timings);
+        this->adapt_read_margin();
+        data::date_margins const& margins    = this->read_margins(timings);
+        data::datetime            read_until = margins.second;
+
+        if (window < this->read_margin) {
+          read_until = std::min(read_until, timings.simulation_time + window);
+          window    *= 2;
+        }
 
-        // read requests until the start time of the request overflows the read margin, requests are automatically sorted thanks to the std::set
+        // read requests until the start time of the last request overflows the read margin, or until the memory budget is
+        // exhausted, requests are automatically sorted thanks to the std::set
         // ie: a read margin of 10min means we are going to read 10mins ahead of the current simulation time
         try {
-          do {
-            pair = requests.insert(this->next());
-          } while (pair.first->start_time < margins.second);
+          while ((requests.empty() || (requests.rbegin()->start_time < read_until)) && (this->read_ahead_bytes < this->read_ahead_budget))
+            this->insert(requests, this->next());
         } catch (std::out_of_range const& e) {}
 
-        // if the buffer is at least half full, continue reading, we will fill it later
-        if (this->buffer.load() >= 50)
+        // if the buffer is at least half full, wait for the simulation to consume it, we will fill it later
+        if (this->buffer.load() >= 50) {
+          boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
           continue;
+        }
 
         // push the requests to the ringbuffer and erase whichever has been successfully pushed
-        requests.erase(requests.begin(), this->push(requests));
+        auto const pushed = this->push(requests);
+        if (first_push && (pushed != requests.begin())) {
+          std::clog << "I: first requests pushed after " << (data::clock::local_time() - started_at).total_milliseconds() << "ms" << std::endl;
+          first_push = false;
+        }
+
+        requests.erase(requests.begin(), pushed);
       } while (this->filestream.good());
 
       std::cerr << "end of file reached, pushing " << requests.size() << " requests." << std::endl;
@@ -120,22 +284,40 @@ namespace logoprism {
         if (boost::this_thread::interruption_requested())
           return;
 
-        requests.erase(requests.begin(), this->push(requests));
+        if (!this->coverage_sampled && this->line_scanner.finished())
+          this->sample_coverage();
+
+        auto const pushed = this->push(requests);
+        if (pushed == requests.begin())
+          boost::this_thread::sleep_for(boost::chrono::milliseconds(10));
+
+        requests.erase(requests.begin(), pushed);
       } while (!requests.empty());
 
       this->reading_thread_running = false;
     }
 
     data::requests reader_base::visible_requests(data::timings const& timings) {
-      data::date_margins const& margins = this->visible_margins(timings);
+      boost::lock_guard< boost::mutex > lock(this->visible_mutex);
+
+      return this->build_keyframe(timings, timings.simulation_time).requests;
+    }
+
+    data::keyframe reader_base::build_keyframe(data::timings const& timings, data::datetime const& time) {
+      data::timings keyframe_timings = timings;
+      keyframe_timings.simulation_time = time;
+
+      // only forget the requests that are not visible anymore at the current time, the keyframe may be used earlier than expected
+      data::date_margins const& current_margins = this->visible_margins(timings);
+      data::date_margins const& margins         = this->visible_margins(keyframe_timings);
 
       // remove requests that are not visible anymore, find the first one with a start_time bigger than the visible margin
       auto const& end = std::find_if(this->visible.begin(), this->visible.end(),
-                                     [&](data::request const& r) { return r.start_time > margins.first; });
+                                     [&](data::request const& r) { return r.start_time > current_margins.first; });
 
       // for any request that started before this one, check if it is still visible or not
       for (auto it = std::begin(this->visible); it != end;) {
-        if (it->start_time + it->duration < margins.first)
+        if (it->start_time + it->duration < current_margins.first)
           this->visible.erase(it++);
         else
           ++it;
@@ -150,19 +332,202 @@ namespace logoprism {
         if (!this->buffer.pop(request))
           break;
 
-        if (request.start_time + request.duration < margins.first)
+        this->read_ahead_bytes -= footprint(request);
+
+        if (request.start_time + request.duration < current_margins.first)
           continue;
 
         this->visible.insert(request);
       }
 
-      return this->visible;
+      data::keyframe keyframe;
+      keyframe.simulation_time = time;
+
+      for (auto const& request : this->visible) {
+        if (request.start_time + request.duration < margins.first)
+          continue;
+
+        keyframe.requests.insert(keyframe.requests.end(), request);
+        keyframe.workers.insert(request.worker);
+      }
+
+      return keyframe;
+    }
+
+    data::keyframe reader_base::next_keyframe(data::timings const& timings, data::duration const& lookahead) {
+      // the prepared keyframe is only used if it is closer to the current time than a tenth of the visible margin
+      data::duration const tolerance = this->visible_margin / 10;
+
+      data::keyframe keyframe;
+      bool           prepared = false;
+      {
+        boost::lock_guard< boost::mutex > lock(this->keyframe_mutex);
+
+        if (this->keyframe_prepared && ((this->prepared_keyframe.simulation_time - timings.simulation_time).abs() <= tolerance)) {
+          std::swap(keyframe, this->prepared_keyframe);
+          prepared = true;
+        } else if (this->keyframe_prepared) {
+          std::clog << "I: keyframe prepared for " << this->prepared_keyframe.simulation_time << ", needed at "
+                    << timings.simulation_time << ", building it again" << std::endl;
+        }
+      }
+
+      if (!prepared) {
+        boost::lock_guard< boost::mutex > lock(this->visible_mutex);
+        keyframe = this->build_keyframe(timings, timings.simulation_time);
+      }
+
+      // ask the keyframe thread to prepare the next one, the one it may still be building is not needed anymore
+      {
+        boost::lock_guard< boost::mutex > lock(this->keyframe_mutex);
+
+        this->keyframe_prepared    = false;
+        this->keyframe_requested   = true;
+        this->keyframe_generation += 1;
+        this->keyframe_timings     = timings;
+        this->keyframe_time        = timings.simulation_time + lookahead;
+        this->keyframe_condition.notify_one();
+      }
+
+      return keyframe;
+    }
+
+    void reader_base::prepare_keyframes() {
+      while (true) {
+        data::timings  timings;
+        data::datetime time;
+        uint64_t       generation;
+        {
+          boost::unique_lock< boost::mutex > lock(this->keyframe_mutex);
+          while (!this->keyframe_requested)
+            this->keyframe_condition.wait(lock);
+
+          this->keyframe_requested = false;
+          timings                  = this->keyframe_timings;
+          time                     = this->keyframe_time;
+          generation               = this->keyframe_generation;
+        }
+
+        // the keyframe is built without the keyframe lock, which the display thread takes every frame, only holding the
+        // visible requests
+        data::keyframe keyframe;
+        {
+          boost::lock_guard< boost::mutex > lock(this->visible_mutex);
+          keyframe = this->build_keyframe(timings, time);
+        }
+
+        // the keyframe is only published if no other has been requested, and no seek has happened, in the meantime
+        boost::lock_guard< boost::mutex > lock(this->keyframe_mutex);
+        if (generation != this->keyframe_generation)
+          continue;
+
+        std::swap(this->prepared_keyframe, keyframe);
+        this->keyframe_prepared = true;
+      }
+    }
+
+    data::duration reader_base::idle_gap(data::timings const& timings) {
+      // the visible requests are not waited for while the keyframe thread builds a keyframe, the gap is then detected on
+      // one of the next frames
+      boost::unique_lock< boost::mutex > lock(this->visible_mutex, boost::try_to_lock);
+      if (!lock.owns_lock())
+        return data::microseconds(0);
+
+      // the request views appear and disappear 2s before and after their start and end times
+      data::duration const lead_time = data::seconds(2);
+
+      if (this->idle_gap_threshold <= data::microseconds(0))
+        return data::microseconds(0);
+
+      // find the first request starting in the future, if any, and check that no other is still running
+      auto const& next = std::find_if(this->visible.begin(), this->visible.end(),
+                                      [&](data::request const& r) { return r.start_time > timings.simulation_time; });
+
+      if (next == this->visible.end())
+        return data::microseconds(0);
+
+      for (auto it = this->visible.begin(); it != next; ++it) {
+        if (it->start_time + it->duration + lead_time >= timings.simulation_time)
+          return data::microseconds(0);
+      }
+
+      data::duration const gap = next->start_time - timings.simulation_time;
+      if (gap < this->idle_gap_threshold)
+        return data::microseconds(0);
+
+      return gap - lead_time;
+    }
+
+    bool reader_base::seek(data::datetime const& time, data::duration const& skip) {
+      // leave some time for the requests logged slightly out of order, or started earlier and still running
+      data::duration const lookback = data::seconds(60);
+
+      // look the checkpoint up first, so that the reading thread and its read ahead requests are left alone without one
+      data::datetime          checkpoint_time;
+      data::reader_checkpoint checkpoint;
+      {
+        boost::lock_guard< boost::mutex > lock(this->checkpoints_mutex);
+        if (!this->checkpoints.nearest(time - lookback, checkpoint_time, checkpoint) && !this->checkpoints.nearest(time, checkpoint_time, checkpoint))
+          return false;
+      }
+
+      std::clog << "I: seeking to " << time << " from checkpoint at " << checkpoint_time << std::endl;
+
+      if (this->reading_thread_running) {
+        this->reading_thread.interrupt();
+        this->reading_thread.join();
+        this->reading_thread_running = false;
+      }
+
+      {
+        // discard whatever has been read ahead, in the ringbuffer and in the reading thread, which is gone with it, and the
+        // keyframe that may be being prepared
+        boost::lock_guard< boost::mutex > visible_lock(this->visible_mutex);
+        boost::lock_guard< boost::mutex > lock(this->keyframe_mutex);
+
+        data::request request;
+        while (this->buffer.pop(request)) {}
+        this->visible.clear();
+        this->read_ahead_bytes     = 0;
+        this->keyframe_requested   = false;
+        this->keyframe_prepared    = false;
+        this->keyframe_generation += 1;
+
+        this->filestream.clear();
+        this->filestream.seekg(checkpoint.offset);
+        this->read_bytes       = checkpoint.offset;
+        this->read_lines       = checkpoint.lines;
+        this->worker_simulator = checkpoint.worker_simulator;
+
+        this->simulator.skip(skip);
+      }
+
+      this->start_reading();
+
+      return true;
     }
 
     size_t reader_base::buffering_percentage() {
       return this->buffer.load();
     }
 
+    data::reading_progress reader_base::progress() {
+      data::reading_progress progress;
+
+      progress.read_bytes = this->read_bytes;
+      progress.file_bytes = this->line_scanner.file_size();
+      progress.read_lines = this->read_lines;
+      progress.file_lines = this->line_scanner.finished() ? this->line_scanner.line_count() : 0;
+      progress.first_time = this->coverage_sampled ? this->first_time : data::datetime(data::not_a_date_time);
+      progress.last_time  = this->coverage_sampled ? this->last_time : data::datetime(data::not_a_date_time);
+
+      progress.read_ahead_bytes = this->read_ahead_bytes;
+      progress.out_of_order     = data::microseconds(this->out_of_order_us.load());
+      progress.read_margin      = data::microseconds(this->read_margin_us.load());
+
+      return progress;
+    }
+
     data::date_margins reader_base::read_margins(data::timings const& timings) {
       return std::make_pair(timings.simulation_time - this->read_margin, timings.simulation_time + this->read_margin);
     }
@@ -6,6 +6,8 @@
 #include "logoprism/data/simulator.hpp"
 #include "logoprism/data/request.hpp"
 #include "logoprism/data/worker_simulator.hpp"
+#include "logoprism/data/line_scanner.hpp"
+#include "logoprism/data/checkpoint_store.hpp"
 
 #include <boost/shared_ptr.hpp>
 #include <boost/thread.hpp>
@@ -16,10 +18,71 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <atomic>
 
 namespace logoprism {
   namespace data {
 
+    /**
+     * Snapshot of the reading progress through the log file, as reported to the display thread.
+     */
+    struct reading_progress {
+      /** the number of bytes read from the file */
+      uint64_t read_bytes;
+
+      /** the size of the file, in bytes */
+      uint64_t file_bytes;
+
+      /** the number of lines read from the file */
+      uint64_t read_lines;
+
+      /** the number of lines in the file, or 0 if the pre-scan is not finished yet */
+      uint64_t file_lines;
+
+      /** the simulated time of the first request in the file, or not_a_date_time if not sampled yet */
+      data::datetime first_time;
+
+      /** the simulated time of the last request in the file, or not_a_date_time if not sampled yet */
+      data::datetime last_time;
+
+      /** the estimated memory used by the requests read ahead, in bytes */
+      uint64_t read_ahead_bytes;
+
+      /** the observed out-of-order distance of the requests in the file */
+      data::duration out_of_order;
+
+      /** the current read margin */
+      data::duration read_margin;
+    };
+
+    /**
+     * Checkpoint of the reading state, from where the reading can be restarted to seek backwards.
+     */
+    struct reader_checkpoint {
+      /** the offset in the file of the line to read next */
+      uint64_t offset;
+
+      /** the number of lines read before that offset */
+      uint64_t lines;
+
+      /** the state of the worker simulator before reading that line */
+      data::worker_simulator worker_simulator;
+    };
+
+    /**
+     * The requests visible at a keyframe, along with the workers handling them.
+     */
+    struct keyframe {
+      /** the simulated time the keyframe has been computed for */
+      data::datetime simulation_time;
+
+      /** the visible sorted requests */
+      data::requests requests;
+
+      /** the workers of the visible requests */
+      std::set< std::string > workers;
+    };
+
     /**
      * Base class for request parsers. Handles the reading, sorting and completion of the requests as well as
      * the inter-thread communication with the display thread.
@@ -30,7 +93,7 @@ namespace logoprism {
          * Creates a new request reader/parser/completer.
          * @param filename       the log file name to load
          * @param simulator      the time simulator to use
-         * @param read_margin    the read margin (how much time we should read ahead of the current simulation time)
+         * @param read_margin    the maximum read margin (how much time we may read ahead of the current simulation time)
          * @param visible_margin the visible margin (how much time ahead we should use when computing visible requests)
          */
         reader_base(std::string const& filename, data::simulator& simulator, data::duration const& read_margin, data::duration const& visible_margin);
@@ -45,33 +108,112 @@ namespace logoprism {
         /** get the current fill percentage of the ringbuffer */
         size_t buffering_percentage();
 
+        /** get the current reading progress through the file */
+        data::reading_progress progress();
+
         /** get the currently visible sorted requests */
         data::requests visible_requests(data::timings const& timings);
 
+        /**
+         * Gets the visible requests and workers for the current keyframe, swapping in the one prepared in the background if
+         * it has been computed close enough to the current simulated time, or computing it synchronously otherwise. The
+         * preparation of the next keyframe is then requested to the keyframe thread.
+         *
+         * @param  timings   the current timings
+         * @param  lookahead the simulated time expected until the next keyframe
+         * @return           the keyframe for the current simulated time
+         */
+        data::keyframe next_keyframe(data::timings const& timings, data::duration const& lookahead);
+
+        /**
+         * Detects an idle gap in the time-ordered visible requests, when no request is running anymore and the next one starts
+         * later than the configured idle gap threshold.
+         *
+         * @param  timings the current timings
+         * @return         how much simulated time can be skipped, or a zero duration if there's no idle gap
+         */
+        data::duration idle_gap(data::timings const& timings);
+
+        /**
+         * Moves the reading backwards, restarting the reading thread from the latest checkpoint taken before the given time.
+         * Any buffered or visible request is discarded, and the reading goes on untouched if there is no such checkpoint.
+         *
+         * @param  time the simulated time to seek to
+         * @param  skip the simulated time to skip to get there, applied before the reading thread is restarted so that it
+         *              never computes timings from the previous skip total
+         * @return      whether a checkpoint has been found to restart from
+         */
+        bool seek(data::datetime const& time, data::duration const& skip);
+
         /** whether there are no more requests buffered and no more requests in the file */
         bool exhausted();
 
       protected:
         friend struct request_reader_thread;
+        friend struct request_keyframe_thread;
 
         data::simulator&     simulator;
-        data::duration const read_margin;
+        data::duration       max_read_margin;
+        data::duration       read_margin;
         data::duration       visible_margin;
+        data::duration       idle_gap_threshold;
+        uint64_t const       read_ahead_budget;
+        data::duration const startup_window;
 
+        /**
+         * The requests popped from the ringbuffer and still visible, only used with the visible mutex held, which the keyframe
+         * thread holds while building a keyframe.
+         */
         data::requests_buffer buffer;
         data::requests        visible;
+        boost::mutex          visible_mutex;
 
         std::ifstream          filestream;
+        data::line_scanner     line_scanner;
         data::worker_simulator worker_simulator;
-        bool volatile          reading_thread_running;
-        boost::thread          reading_thread;
+
+        /** the checkpoints are taken by the reading thread and looked up by the display thread */
+        data::checkpoint_store< data::reader_checkpoint > checkpoints;
+        boost::mutex                                      checkpoints_mutex;
+
+        std::atomic< uint64_t > read_bytes;
+        std::atomic< uint64_t > read_lines;
+        std::atomic< bool >     coverage_sampled;
+        data::datetime          first_time;
+        data::datetime          last_time;
+
+        std::atomic< uint64_t > read_ahead_bytes;
+        std::atomic< int64_t >  out_of_order_us;
+        std::atomic< int64_t >  read_margin_us;
+        data::datetime          latest_start_time;
+        data::duration          out_of_order_windows[2];
+        size_t                  out_of_order_count;
+
+        boost::mutex              keyframe_mutex;
+        boost::condition_variable keyframe_condition;
+        data::timings             keyframe_timings;
+        data::datetime            keyframe_time;
+        bool                      keyframe_requested;
+        bool                      keyframe_prepared;
+        uint64_t                  keyframe_generation;
+        data::keyframe            prepared_keyframe;
+        boost::thread             keyframe_thread;
+
+        bool volatile reading_thread_running;
+        boost::thread reading_thread;
 
         data::date_margins read_margins(data::timings const& timings);
         data::date_margins visible_margins(data::timings const& timings);
 
         data::requests::iterator push(data::requests const& requests);
+        void                     insert(data::requests& requests, data::request const& request);
+        void                     adapt_read_margin();
         data::request            next();
+        void                     start_reading();
+        void                     sample_coverage();
         void                     run();
+        data::keyframe           build_keyframe(data::timings const& timings, data::datetime const& time);
+        void                     prepare_keyframes();
 
         virtual data::request parse(std::string const& line) = 0;
     };
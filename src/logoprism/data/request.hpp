@@ -59,7 +59,7 @@ namespace logoprism {
     };
 
     typedef std::set< data::request >                  requests;
-    typedef data::ringbuffer< data::request, 1000000 > requests_buffer;
+    typedef data::ringbuffer< data::request, 1 << 16 > requests_buffer;
 
     template< typename T >
     static inline std::basic_ostream< T >& operator<<(std::basic_ostream< T >& stream, data::request const& request) {
@@ -38,6 +38,9 @@ namespace logoprism {
         position_type volatile reader;
 
       public:
+        /** the number of items the ringbuffer is sized for */
+        static size_t const capacity = Size;
+
         ringbuffer() :
           writer(0),
           reader(0)
@@ -9,7 +9,7 @@ namespace logoprism {
       simulation_speed(simulation_speed),
       key_frame_duration(key_frame_duration / std::max(1.0, simulation_speed)),
       timelapse_duration(data::microseconds(0)),
-      skip_duration(data::microseconds(0))
+      skip_duration(0)
     {}
 
     data::timings simulator::timings(data::timings const& last_timings) {
@@ -27,8 +27,11 @@ namespace logoprism {
         timings.keyframe_time = data::clock::local_time();
 
       // if the simulation time is not set, probably first tick, use the provided reference point
-      if (timings.simulation_time == data::not_a_date_time)
-        timings.simulation_time = this->simulation_reference_time;
+      data::duration const simulation_skipped = data::microseconds(this->skip_duration.load());
+      if (timings.simulation_time == data::not_a_date_time) {
+        timings.simulation_time    = this->simulation_reference_time;
+        timings.simulation_skipped = simulation_skipped;
+      }
 
       // if we have been provided a fixed timelapse, use it, or find the difference between current time and previous time
       if (this->timelapse_duration != data::microseconds(0))
@@ -47,9 +50,15 @@ namespace logoprism {
       timings.simulation_timelapse = data::microseconds(static_cast< int64_t >(timings.timelapse.total_microseconds() * this->speed()));
       timings.simulation_time     += timings.simulation_timelapse;
 
+      // apply the simulated time that has been skipped since the previous tick, if any
+      bool const skipped = timings.simulation_skipped != simulation_skipped;
+      timings.simulation_time   += simulation_skipped - timings.simulation_skipped;
+      timings.simulation_skipped = simulation_skipped;
+
       // compute whether this is a keyframe or not, depending on the configured keyframe duration
       timings.is_keyframe  = (timings.time - timings.keyframe_time) >= (this->key_frame_duration / std::max(1.0, timings.simulation_speed));
       timings.is_keyframe |= last_timings.time >= timings.time;
+      timings.is_keyframe |= skipped;
 
       // if this is a keyframe, update the keyframe_time
       if (timings.is_keyframe)
@@ -79,5 +88,9 @@ namespace logoprism {
       this->simulation_paused = !this->simulation_paused;
     }
 
+    void simulator::skip(data::duration const& skip_duration) {
+      this->skip_duration += skip_duration.total_microseconds();
+    }
+
   }
 }
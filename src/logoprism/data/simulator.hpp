@@ -3,6 +3,8 @@
 
 #include "logoprism/data/datetime.hpp"
 
+#include <atomic>
+
 namespace logoprism {
   namespace data {
 
@@ -35,13 +37,18 @@ namespace logoprism {
       /** pauses/unpauses the simulation */
       void toggle_pause();
 
+      /** skips some simulated time, for every thread computing timings from this simulator */
+      void skip(data::duration const& skip_duration);
+
       protected:
         data::datetime simulation_reference_time;
         bool           simulation_paused;
         double         simulation_speed;
         data::duration key_frame_duration;
         data::duration timelapse_duration;
-        data::duration skip_duration;
+
+        /** the total simulated time skipped, in microseconds */
+        std::atomic< int64_t > skip_duration;
 
       private:
         simulator(simulator const&);
@@ -1,6 +1,8 @@
 #include "logoprism/logoprism.hpp"
 
 #include "logoprism/utils/signals.hpp"
+#include "logoprism/utils/arena.hpp"
+#include "logoprism/utils/allocations.hpp"
 #include "logoprism/data/request_reader.hpp"
 #include "logoprism/view/string_list.hpp"
 #include "logoprism/video/encoder.hpp"
@@ -9,6 +11,8 @@
 #include "logoprism/renderer/opengl.hpp"
 #include "logoprism/renderer/cairo.hpp"
 
+#include <iomanip>
+#include <sstream>
 #include <stdexcept>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
@@ -17,6 +21,20 @@
 
 namespace logoprism {
 
+  /** formats a duration in a short human readable form, such as 2h13m, 13m27s or 42s */
+  static std::string short_duration(data::duration const& duration) {
+    std::stringstream stream;
+
+    if (duration.hours() > 0)
+      stream << duration.hours() << "h" << std::setfill('0') << std::setw(2) << duration.minutes() << "m";
+    else if (duration.minutes() > 0)
+      stream << duration.minutes() << "m" << std::setfill('0') << std::setw(2) << duration.seconds() << "s";
+    else
+      stream << duration.seconds() << "s";
+
+    return stream.str();
+  }
+
   logoprism::logoprism() :
     application(),
     simulator(config::get("input.speed", 1.0), data::microseconds(static_cast< size_t >(config::get("input.keyframe-duration-us", 1000000)))),
@@ -24,7 +42,14 @@ namespace logoprism {
     keep_alive(config::get("input.keepalive")),
     display_size(config::get("display.width"), config::get("display.height")),
     request_views(glm::vec2(0.0, 0.0), this->display_size, this->keep_alive),
-    info_view(this->display_size / 2.0f, this->display_size) {
+    info_view(this->display_size / 2.0f, this->display_size),
+    layouts(data::seconds(static_cast< long >(config::get("input.checkpoint-interval-s", 60))), 1024),
+    startup_time(data::clock::local_time()),
+    first_frame(true),
+    keyframe_time(data::not_a_date_time),
+    tick_time(data::not_a_date_time),
+    simulation_rate(0.0),
+    text_cache_evictions(0) {
     namespace bfs = boost::filesystem;
 
     if (this->offscreen || (config::get("display.renderer") == "cairo"))
@@ -47,8 +72,18 @@ namespace logoprism {
   }
 
   void logoprism::tick() {
+    uint64_t const allocations = utils::allocations::count();
+
     this->timings = this->simulator.timings(this->timings);
 
+    // measure how fast the simulated time flows compared to the real time, including rendering and encoding time
+    data::datetime const tick_time = data::clock::local_time();
+    if (!this->tick_time.is_not_a_date_time() && (tick_time > this->tick_time)) {
+      double const simulation_rate = data::floating_seconds(this->timings.simulation_timelapse) / data::floating_seconds(tick_time - this->tick_time);
+      this->simulation_rate = (this->simulation_rate == 0.0) ? simulation_rate : this->simulation_rate * 0.95 + simulation_rate * 0.05;
+    }
+    this->tick_time = tick_time;
+
     this->logic();
     this->draw();
 
@@ -60,14 +95,35 @@ namespace logoprism {
       this->on_key_press(this->timings);
       this->pressed_keys_delay += data::microseconds(300000);
     }
+
+    // the frame transient data is released all at once
+    utils::arena& arena = utils::arena::frame();
+    if (this->timings.is_keyframe && utils::allocations::enabled())
+      std::clog << "I: " << (utils::allocations::count() - allocations) << " heap allocations, "
+                << arena.allocated_bytes() << " bytes from the frame arena" << std::endl;
+    arena.reset();
   }
 
   void logoprism::logic() {
     this->info_view.set_buffer_percentage(this->request_reader->buffering_percentage());
-
-    if (this->timings.is_keyframe) {
-      data::requests const& visible_requests = this->request_reader->visible_requests(this->timings);
-      this->request_views.set_requests(visible_requests);
+    this->info_view.set_progress(this->request_reader->progress(), this->timings, this->simulation_rate);
+
+    // until the first requests are displayed, look for them on every frame instead of waiting for the next keyframe
+    if (this->timings.is_keyframe || this->first_frame) {
+      // the visible requests are prepared in the background, expecting the next keyframe to come as far as this one
+      data::duration lookahead = data::microseconds(0);
+      if (!this->keyframe_time.is_not_a_date_time() && (this->timings.simulation_time > this->keyframe_time))
+        lookahead = this->timings.simulation_time - this->keyframe_time;
+      this->keyframe_time = this->timings.simulation_time;
+
+      data::keyframe        keyframe         = this->request_reader->next_keyframe(this->timings, lookahead);
+      data::requests const& visible_requests = keyframe.requests;
+      size_t const          visible_count    = visible_requests.size();
+
+      if (this->first_frame && !visible_requests.empty()) {
+        std::clog << "I: first frame after " << (data::clock::local_time() - this->startup_time).total_milliseconds() << "ms" << std::endl;
+        this->first_frame = false;
+      }
 
       if (visible_requests.empty())
         this->info_view.set_message("buffering...");
@@ -75,10 +131,24 @@ namespace logoprism {
         std::clog << "visible requests from " << visible_requests.begin()->start_time
                   << " to " << visible_requests.rbegin()->start_time << std::endl;
 
-      if (visible_requests.empty() && this->request_reader->exhausted())
+      this->request_views.set_requests(std::move(keyframe));
+
+      // fast-forward through long quiet stretches instead of playing them at the current speed
+      data::duration const idle_gap = this->request_reader->idle_gap(this->timings);
+      if (idle_gap > data::microseconds(0)) {
+        this->simulator.skip(idle_gap);
+        this->info_view.set_message("skipped " + short_duration(idle_gap));
+        std::clog << "I: skipping idle gap of " << idle_gap << std::endl;
+      }
+
+      // keep the string views layout from time to time, to restore it when rewinding
+      if (this->layouts.due(this->timings.simulation_time))
+        this->layouts.insert(this->timings.simulation_time, this->request_views.layout());
+
+      if ((visible_count == 0) && this->request_reader->exhausted())
         utils::signals::kill();
       else
-        std::clog << visible_requests.size() << " visible requests." << std::endl;
+        std::clog << visible_count << " visible requests." << std::endl;
     }
 
     this->request_views.logic(this->timings);
@@ -88,14 +158,29 @@ namespace logoprism {
   void logoprism::draw() {
     this->renderer->erase();
 
+    // the information overlay is drawn over the requests, whatever the renderer batching
     this->request_views.draw(*this->renderer, this->timings);
+    this->renderer->layer(1);
     this->info_view.draw(*this->renderer, this->timings);
+    this->renderer->flush();
 
-    if (this->timings.is_keyframe)
+    if (this->timings.is_keyframe) {
       this->renderer->cleanup_cache();
+
+      // report the text cache usage when it starts evicting text, as the budget may be too small for the input
+      renderer::cache_statistics const statistics = this->renderer->text_cache_statistics();
+      if (statistics.evictions > this->text_cache_evictions) {
+        std::clog << "I: text cache: " << statistics.entries << " entries, " << (statistics.bytes >> 10) << "KB, " << statistics.hits << " hits, "
+                  << statistics.misses << " misses, " << statistics.evictions << " evictions" << std::endl;
+        this->text_cache_evictions = statistics.evictions;
+      }
+    }
   }
 
   void logoprism::on_key_press(data::timings const&) {
+    // dense frames are bundled by the request flow, so the speed is only limited by the reading throughput
+    static double const max_speed = config::get("input.max-speed", 1000.0);
+
     if (this->pressed_keys.none())
       return;
 
@@ -138,10 +223,27 @@ namespace logoprism {
       this->pressed_keys_delay = this->timings.skip_timelapse;
     }
 
+    if (this->pressed_keys % input::keyset::left) {
+      if ((this->pressed_keys & (input::keyset::left_control | input::keyset::right_control))
+          && (this->pressed_keys & (input::keyset::left_alt | input::keyset::right_alt))) {
+        this->info_view.set_message("← 1h");
+        this->rewind(data::seconds(3600));
+      } else if (this->pressed_keys & (input::keyset::left_alt | input::keyset::right_alt)) {
+        this->info_view.set_message("← 1m");
+        this->rewind(data::seconds(60));
+      } else if (this->pressed_keys & (input::keyset::left_control | input::keyset::right_control)) {
+        this->info_view.set_message("← 5s");
+        this->rewind(data::seconds(5));
+      } else {
+        this->info_view.set_message("← 1s");
+        this->rewind(data::seconds(1));
+      }
+    }
+
     if ((this->pressed_keys % input::keyset::numpad_add)
         || (this->pressed_keys % (input::keyset::equal | input::keyset::right_shift))
         || (this->pressed_keys % (input::keyset::equal | input::keyset::left_shift)))
-      if (this->simulator.speed() < 100.0) {
+      if (this->simulator.speed() < max_speed) {
         speed = (speed == 10) ? 25 : speed * 2;
         this->simulator.set_speed(speed * speed_pow);
         this->info_view.set_speed(this->simulator.speed());
@@ -180,4 +282,18 @@ namespace logoprism {
 
   } // on_key_press
 
+  void logoprism::rewind(data::duration const& duration) {
+    data::datetime const target = this->timings.simulation_time - duration;
+
+    // restart the reading from the nearest checkpoint, and restore the string views layout as it was at that time
+    if (!this->request_reader->seek(target, target - this->timings.simulation_time))
+      return;
+
+    data::datetime               layout_time;
+    view::request_flow::layout_t layout;
+    if (!this->layouts.nearest(target, layout_time, layout))
+      layout = view::request_flow::layout_t();
+    this->request_views.restore(layout);
+  }
+
 }
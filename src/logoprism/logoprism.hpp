@@ -6,6 +6,7 @@
 
 #include "logoprism/data/request_reader.hpp"
 #include "logoprism/data/simulator.hpp"
+#include "logoprism/data/checkpoint_store.hpp"
 #include "logoprism/view/request.hpp"
 #include "logoprism/view/request_flow.hpp"
 #include "logoprism/view/info.hpp"
@@ -24,6 +25,7 @@ namespace logoprism {
 
     private:
       void on_key_press(data::timings const& timings);
+      void rewind(data::duration const& duration);
 
       void logic();
       void draw();
@@ -40,8 +42,20 @@ namespace logoprism {
       view::request_flow request_views;
       view::info         info_view;
 
+      data::checkpoint_store< view::request_flow::layout_t > layouts;
+
       std::set< data::request > visible_requests;
       data::timings             timings;
+
+      data::datetime const startup_time;
+      bool                 first_frame;
+
+      data::datetime keyframe_time;
+      data::datetime tick_time;
+      double         simulation_rate;
+
+      /** the text cache evictions already reported */
+      uint64_t text_cache_evictions;
   };
 
 }
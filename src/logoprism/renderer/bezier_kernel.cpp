@@ -0,0 +1,156 @@
+#include "logoprism/renderer/bezier_kernel.hpp"
+
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+# define LOGOPRISM_BEZIER_KERNEL_SSE
+# include <xmmintrin.h>
+#endif // if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+
+namespace logoprism {
+  namespace renderer {
+
+    namespace {
+
+      /** the maximum number of times a piece of curve is split in halves */
+      static size_t const subdivision_depth = 16;
+
+      /** the point of the curve at the given parameter */
+      static glm::vec2 point_at(glm::vec2 const* const curve, float const t) {
+        float const u = 1.0f - t;
+        return curve[0] * (u * u * u) + curve[1] * (3.0f * u * u * t) + curve[2] * (3.0f * u * t * t) + curve[3] * (t * t * t);
+      }
+
+      /** the derivative of the curve at the given parameter */
+      static glm::vec2 tangent_at(glm::vec2 const* const curve, float const t) {
+        float const u = 1.0f - t;
+        return (curve[1] - curve[0]) * (3.0f * u * u) + (curve[2] - curve[1]) * (6.0f * u * t) + (curve[3] - curve[2]) * (3.0f * t * t);
+      }
+
+      /** the distance between a point and the line through the chord ends, or the first end if they are the same */
+      static float chord_distance(glm::vec2 const& point, glm::vec2 const& begin, glm::vec2 const& end) {
+        glm::vec2 const chord  = end - begin;
+        glm::vec2 const offset = point - begin;
+        float const     length = glm::length(chord);
+
+        if (length <= std::numeric_limits< float >::epsilon())
+          return glm::length(offset);
+
+        return std::fabs(chord.x * offset.y - chord.y * offset.x) / length;
+      }
+
+      /**
+       * Appends the end parameters of the flat enough pieces of the curve between the given parameters, splitting them
+       * in halves as long as the budget allows.
+       * @return the number of segments appended, between 1 and budget
+       */
+      static size_t subdivide_piece(glm::vec2 const* const curve, float const begin, float const end, float const tolerance, size_t const budget,
+                                    size_t const depth, std::vector< float >& parameters) {
+        // the control points of the piece, from the end points and the tangents of the curve, and the piece lies within
+        // their convex hull, so it does not deviate from its chord by more than its inner control points
+        float const     third = (end - begin) / 3.0f;
+        glm::vec2 const p0    = point_at(curve, begin);
+        glm::vec2 const p3    = point_at(curve, end);
+        glm::vec2 const p1    = p0 + tangent_at(curve, begin) * third;
+        glm::vec2 const p2    = p3 - tangent_at(curve, end) * third;
+
+        bool const flat = std::max(chord_distance(p1, p0, p3), chord_distance(p2, p0, p3)) <= tolerance;
+        if (flat || (budget < 2) || (depth == 0)) {
+          parameters.push_back(end);
+          return 1;
+        }
+
+        float const  middle = (begin + end) / 2.0f;
+        size_t const first  = subdivide_piece(curve, begin, middle, tolerance, budget - 1, depth - 1, parameters);
+        return first + subdivide_piece(curve, middle, end, tolerance, budget - first, depth - 1, parameters);
+      }
+
+    }
+
+    void bezier_kernel::evaluate(renderer::curve::control_points_type const& points, float const* const parameters, size_t const count,
+                                 glm::vec2 const& fading, float* const x, float* const y, float* const alpha) {
+      // the curves go from their last control point at parameter 0 to their first one at parameter 1
+      glm::vec2 const& p0 = std::get< 3 >(points);
+      glm::vec2 const& p1 = std::get< 2 >(points);
+      glm::vec2 const& p2 = std::get< 1 >(points);
+      glm::vec2 const& p3 = std::get< 0 >(points);
+
+      // the alpha goes from 0 to 1 between fading.x and fading.y, whichever the direction, or is a step if they are equal
+      float const fading_start = fading.x;
+      float const fading_scale = (fading.y != fading.x) ? 1.0f / (fading.y - fading.x) : std::numeric_limits< float >::max();
+
+      size_t i = 0;
+
+#ifdef LOGOPRISM_BEZIER_KERNEL_SSE
+      __m128 const one   = _mm_set1_ps(1.0f);
+      __m128 const three = _mm_set1_ps(3.0f);
+      __m128 const zero  = _mm_setzero_ps();
+
+      __m128 const x0 = _mm_set1_ps(p0.x), x1 = _mm_set1_ps(p1.x), x2 = _mm_set1_ps(p2.x), x3 = _mm_set1_ps(p3.x);
+      __m128 const y0 = _mm_set1_ps(p0.y), y1 = _mm_set1_ps(p1.y), y2 = _mm_set1_ps(p2.y), y3 = _mm_set1_ps(p3.y);
+
+      __m128 const fading_start4 = _mm_set1_ps(fading_start);
+      __m128 const fading_scale4 = _mm_set1_ps(fading_scale);
+
+      for (; i + 4 <= count; i += 4) {
+        __m128 const t  = _mm_loadu_ps(parameters + i);
+        __m128 const u  = _mm_sub_ps(one, t);
+        __m128 const tt = _mm_mul_ps(t, t);
+        __m128 const uu = _mm_mul_ps(u, u);
+
+        __m128 const b0 = _mm_mul_ps(uu, u);
+        __m128 const b1 = _mm_mul_ps(three, _mm_mul_ps(uu, t));
+        __m128 const b2 = _mm_mul_ps(three, _mm_mul_ps(tt, u));
+        __m128 const b3 = _mm_mul_ps(tt, t);
+
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, x0), _mm_mul_ps(b1, x1)), _mm_add_ps(_mm_mul_ps(b2, x2), _mm_mul_ps(b3, x3))));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(b0, y0), _mm_mul_ps(b1, y1)), _mm_add_ps(_mm_mul_ps(b2, y2), _mm_mul_ps(b3, y3))));
+        _mm_storeu_ps(alpha + i, _mm_min_ps(one, _mm_max_ps(zero, _mm_mul_ps(_mm_sub_ps(t, fading_start4), fading_scale4))));
+      }
+#endif // ifdef LOGOPRISM_BEZIER_KERNEL_SSE
+
+      for (; i < count; ++i) {
+        float const t  = parameters[i];
+        float const u  = 1.0f - t;
+        float const b0 = u * u * u;
+        float const b1 = 3.0f * u * u * t;
+        float const b2 = 3.0f * u * t * t;
+        float const b3 = t * t * t;
+
+        x[i]     = b0 * p0.x + b1 * p1.x + b2 * p2.x + b3 * p3.x;
+        y[i]     = b0 * p0.y + b1 * p1.y + b2 * p2.y + b3 * p3.y;
+        alpha[i] = std::min(1.0f, std::max(0.0f, (t - fading_start) * fading_scale));
+      }
+    } // evaluate
+
+    void bezier_kernel::subdivide(renderer::curve::control_points_type const& points, glm::vec2 const& range, glm::vec2 const& fading, float const tolerance,
+                                  size_t const limit, std::vector< float >& parameters) {
+      glm::vec2 const curve[4] = { std::get< 3 >(points), std::get< 2 >(points), std::get< 1 >(points), std::get< 0 >(points) };
+
+      // the range is cut at the ends of the fading, and each piece gets the segments the previous ones have left, keeping
+      // at least one segment for each of the next pieces
+      float  cuts[4];
+      size_t cut_count = 0;
+      cuts[cut_count++] = range.x;
+      for (float const cut : { std::min(fading.x, fading.y), std::max(fading.x, fading.y) }) {
+        if ((cut > cuts[cut_count - 1]) && (cut < range.y))
+          cuts[cut_count++] = cut;
+      }
+      cuts[cut_count++] = range.y;
+
+      parameters.push_back(range.x);
+
+      size_t used = 0;
+      for (size_t i = 0; i + 1 < cut_count; ++i) {
+        size_t const remaining = cut_count - 2 - i;
+        size_t const budget    = (limit > used + remaining) ? limit - used - remaining : 1;
+
+        used += subdivide_piece(curve, cuts[i], cuts[i + 1], std::max(tolerance, std::numeric_limits< float >::epsilon()), budget, subdivision_depth, parameters);
+      }
+    }
+
+  }
+}
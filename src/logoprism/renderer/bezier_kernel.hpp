@@ -0,0 +1,52 @@
+#ifndef __LOGOPRISM_RENDERER_BEZIER_KERNEL_HPP__
+#define __LOGOPRISM_RENDERER_BEZIER_KERNEL_HPP__
+
+#include "logoprism/renderer/renderer.hpp"
+
+#include <vector>
+
+namespace logoprism {
+  namespace renderer {
+
+    /**
+     * Evaluation of cubic bezier curves at many parameters at once, from the Bernstein polynomials, four parameters per
+     * instruction when SSE is available. The positions and the fading alpha are written to separate caller buffers, so
+     * that the renderers can tessellate the curves into their own vertex format.
+     *
+     * As everywhere in the renderers, a curve goes from its last control point at parameter 0 to its first one at 1.
+     */
+    struct bezier_kernel {
+      public:
+        /**
+         * Evaluates the curve at the given parameters.
+         * @param points     the control points of the curve
+         * @param parameters the parameters to evaluate the curve at
+         * @param count      the number of parameters
+         * @param fading     the parameters where the curve is fully transparent and fully opaque
+         * @param x          the buffer for the abscissa of the points, of at least count floats
+         * @param y          the buffer for the ordinate of the points, of at least count floats
+         * @param alpha      the buffer for the fading alpha of the points, of at least count floats
+         */
+        static void evaluate(renderer::curve::control_points_type const& points, float const* const parameters, size_t const count,
+                             glm::vec2 const& fading, float* const x, float* const y, float* const alpha);
+
+        /**
+         * Computes the parameters where the visible range of the curve has to be evaluated so that the polyline does not
+         * deviate from the curve by more than the given tolerance. The range is split in halves until the inner control
+         * points of each piece are within the tolerance of its chord, so that the straight parts of the curves only take a
+         * few segments. The ends of the fading within the range are always sampled, so that the alpha ramp is exact.
+         * @param points     the control points of the curve
+         * @param range      the visible range of the curve, range.x not greater than range.y
+         * @param fading     the parameters where the curve is fully transparent and fully opaque
+         * @param tolerance  the maximum distance between the curve and the polyline, in pixels
+         * @param limit      the maximum number of segments, at least 3
+         * @param parameters the buffer the parameters are appended to, increasing from range.x to range.y
+         */
+        static void subdivide(renderer::curve::control_points_type const& points, glm::vec2 const& range, glm::vec2 const& fading, float const tolerance,
+                              size_t const limit, std::vector< float >& parameters);
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_RENDERER_BEZIER_KERNEL_HPP__
@@ -1,6 +1,10 @@
 #include "logoprism/renderer/cairo.hpp"
+#include "logoprism/renderer/bezier_kernel.hpp"
+#include "logoprism/renderer/gl_extensions.hpp"
+#include "logoprism/renderer/text_cache.hpp"
 #include "logoprism/view/object.hpp"
 #include "logoprism/config/config.hpp"
+#include "logoprism/utils/thread_pool.hpp"
 
 #include <GL/glext.h>
 
@@ -9,17 +13,34 @@
 #include <pango/pango-layout.h>
 #include <pango/pangocairo.h>
 
-#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
 
 namespace logoprism {
   namespace renderer {
 
+    namespace {
+      /** maximum number of points of the curve polylines */
+      static size_t const curve_segments = 64;
+    }
+
     struct cairo::impl {
       impl(glm::ivec2 const& source_dimension) :
         source_dimension(source_dimension),
         pango_context(pango_font_map_create_context(pango_cairo_font_map_get_default())),
         cairo_surface(cairo_image_surface_create(CAIRO_FORMAT_ARGB32, this->source_dimension.x, this->source_dimension.y)),
-        cairo_context(cairo_create(this->cairo_surface)) {
+        cairo_context(cairo_create(this->cairo_surface)),
+        text_cache(static_cast< size_t >(config::get("display.text-cache-mb", 32)) << 20),
+        screen_texture(0),
+        pixel_buffer(0),
+        changed(false) {
+        this->pixel_buffers[0] = 0;
+        this->pixel_buffers[1] = 0;
+
         cairo_font_options_t* const font_options = cairo_font_options_create();
 
         cairo_font_options_set_antialias(font_options, CAIRO_ANTIALIAS_SUBPIXEL);
@@ -29,106 +50,362 @@ namespace logoprism {
         pango_cairo_context_set_font_options(pango_context, font_options);
         cairo_font_options_destroy(font_options);
 
-        cairo_set_antialias(this->cairo_context, CAIRO_ANTIALIAS_SUBPIXEL);
         cairo_set_source_rgba(this->cairo_context, 0.0, 0.0, 0.0, 1.0);
         cairo_reset_clip(this->cairo_context);
         cairo_paint(this->cairo_context);
         cairo_surface_flush(this->cairo_surface);
 
-        cairo_scale(this->cairo_context, 1.0, -1.0);
-        cairo_translate(this->cairo_context, 0.0, -this->source_dimension.y);
+        this->setup(this->cairo_context, 0);
+        this->create_tiles(config::get("display.cairo-tiles", 0));
       }
 
       ~impl() {
+        if (this->pixel_buffers[0])
+          gl_extensions::get().delete_buffers(2, this->pixel_buffers);
+
+        if (this->screen_texture)
+          glDeleteTextures(1, &this->screen_texture);
+
+        for (auto const& tile : this->tiles) {
+          cairo_destroy(tile.context);
+          cairo_surface_destroy(tile.surface);
+        }
+
         cairo_destroy(this->cairo_context);
         cairo_surface_destroy(this->cairo_surface);
         g_object_unref(this->pango_context);
       }
 
       /**
-       * Cached text handle, keeping reference to a pango context and layout, in order not to have to
-       * recompute them each time.
+       * Cached text, laid out once by pango and kept as runs of glyphs with the cairo scaled font they are drawn with, so
+       * that the tiles can draw it concurrently with cairo alone, the pango objects not being safe to share between
+       * threads.
        */
       struct text_handle {
-        text_handle() : pango_font(nullptr), pango_layout(nullptr) {}
-        text_handle(PangoContext* const pango_context, std::string const& text, text::anchor const& anchor, std::string const& font) :
-          pango_font(pango_font_description_from_string(font.c_str())),
-          pango_layout(pango_layout_new(pango_context)) {
-          pango_context_set_font_description(pango_context, this->pango_font);
-          pango_layout_context_changed(this->pango_layout);
+        struct glyph_run {
+          cairo_scaled_font_t*         font;
+          std::vector< cairo_glyph_t > glyphs;
+        };
+
+        /** lays the text out, the pango context must already match the transformation of the cairo contexts */
+        text_handle(PangoContext* const pango_context, std::string const& text, text::anchor const& anchor, std::string const& font) {
+          PangoFontDescription* const pango_font   = pango_font_description_from_string(font.c_str());
+          PangoLayout* const          pango_layout = pango_layout_new(pango_context);
+
+          // the font is set on the layout rather than on the shared context, so that laying a text out does not invalidate the others
+          pango_layout_set_font_description(pango_layout, pango_font);
 
           switch (anchor) {
             case text::anchor::TOP_LEFT:
             case text::anchor::CENTER_LEFT:
             case text::anchor::BOTTOM_LEFT:
-              pango_layout_set_alignment(this->pango_layout, PANGO_ALIGN_LEFT);
+              pango_layout_set_alignment(pango_layout, PANGO_ALIGN_LEFT);
               break;
 
             case text::anchor::TOP_CENTER:
             case text::anchor::CENTER_CENTER:
             case text::anchor::BOTTOM_CENTER:
-              pango_layout_set_alignment(this->pango_layout, PANGO_ALIGN_CENTER);
+              pango_layout_set_alignment(pango_layout, PANGO_ALIGN_CENTER);
               break;
 
             case text::anchor::TOP_RIGHT:
             case text::anchor::CENTER_RIGHT:
             case text::anchor::BOTTOM_RIGHT:
-              pango_layout_set_alignment(this->pango_layout, PANGO_ALIGN_RIGHT);
+              pango_layout_set_alignment(pango_layout, PANGO_ALIGN_RIGHT);
               break;
           }
-          pango_layout_set_markup(this->pango_layout, text.c_str(), -1);
+          pango_layout_set_markup(pango_layout, text.c_str(), -1);
 
-          pango_layout_get_pixel_size(this->pango_layout, &this->dimensions.x, &this->dimensions.y);
+          pango_layout_get_pixel_size(pango_layout, &this->dimensions.x, &this->dimensions.y);
           this->dimensions = glm::ivec2(glm::vec2(this->dimensions));
-        }
 
-        text_handle(text_handle&& o) :
-          pango_font(o.pango_font),
-          pango_layout(o.pango_layout),
-          dimensions(o.dimensions),
-          used(o.used) {
-          o.pango_font   = nullptr;
-          o.pango_layout = nullptr;
+          // the glyphs are positioned from the top left corner of the layout, on the baseline of their line
+          PangoLayoutIter* const iter = pango_layout_get_iter(pango_layout);
+          do {
+            PangoLayoutRun const* const run = pango_layout_iter_get_run_readonly(iter);
+            if (!run)
+              continue;
+
+            cairo_scaled_font_t* const scaled_font = pango_cairo_font_get_scaled_font(PANGO_CAIRO_FONT(run->item->analysis.font));
+            if (!scaled_font)
+              continue;
+
+            PangoRectangle logical;
+            pango_layout_iter_get_run_extents(iter, NULL, &logical);
+            int const baseline = pango_layout_iter_get_baseline(iter);
+
+            glyph_run glyphs;
+            glyphs.font = cairo_scaled_font_reference(scaled_font);
+
+            int x = logical.x;
+            for (int i = 0; i < run->glyphs->num_glyphs; ++i) {
+              PangoGlyphInfo const& info = run->glyphs->glyphs[i];
+
+              if ((info.glyph != PANGO_GLYPH_EMPTY) && !(info.glyph & PANGO_GLYPH_UNKNOWN_FLAG)) {
+                cairo_glyph_t glyph;
+                glyph.index = info.glyph;
+                glyph.x     = static_cast< double >(x + info.geometry.x_offset) / PANGO_SCALE;
+                glyph.y     = static_cast< double >(baseline + info.geometry.y_offset) / PANGO_SCALE;
+                glyphs.glyphs.push_back(glyph);
+              }
+
+              x += info.geometry.width;
+            }
+
+            this->runs.push_back(std::move(glyphs));
+          } while (pango_layout_iter_next_run(iter));
+
+          pango_layout_iter_free(iter);
+          g_object_unref(pango_layout);
+          pango_font_description_free(pango_font);
         }
 
         ~text_handle() {
-          if (this->pango_font)
-            pango_font_description_free(this->pango_font);
+          for (auto const& run : this->runs) {
+            cairo_scaled_font_destroy(run.font);
+          }
+        }
+
+        /** the memory used by the glyphs of the text */
+        size_t footprint() const {
+          size_t bytes = sizeof(text_handle);
+          for (auto const& run : this->runs) {
+            bytes += sizeof(glyph_run) + run.glyphs.capacity() * sizeof(cairo_glyph_t);
+          }
 
-          if (this->pango_layout)
-            g_object_unref(this->pango_layout);
+          return bytes;
         }
 
-        PangoFontDescription* pango_font;
-        PangoLayout*          pango_layout;
-        glm::ivec2            dimensions;
-        bool                  used;
+        text_handle(text_handle const&)            = delete;
+        text_handle& operator=(text_handle const&) = delete;
+
+        std::vector< glyph_run > runs;
+        glm::ivec2               dimensions;
       };
 
-      text_handle const& make_text(std::string const& text, text::anchor const& anchor, std::string const& font) {
-        std::string const& key = text + " - " + font + " - " + boost::lexical_cast< std::string >(static_cast< size_t >(anchor));
+      /**
+       * A drawing command of the frame, recorded to be replayed by every tile it overlaps. The text handles are shared
+       * with the text cache, so that they outlive an eviction during the frame.
+       */
+      struct command {
+        std::shared_ptr< text_handle const > text;
+        glm::vec2                            top_left;
+
+        /** the range of the curve polyline in the frame points */
+        size_t first;
+        size_t count;
+        double width;
+
+        glm::vec4 color;
+
+        /** the surface rows the command may touch, as [first, last) */
+        glm::ivec2 rows;
+      };
+
+      /** a horizontal band of the surface, drawn by its own cairo context */
+      struct tile {
+        cairo_surface_t* surface;
+        cairo_t*         context;
+        glm::ivec2       rows;
+      };
+
+      std::shared_ptr< text_handle > const& make_text(std::string const& text, text::anchor const& anchor, std::string const& font) {
+        std::shared_ptr< text_handle > const* const handle = this->text_cache.find(text, anchor, font);
+        if (handle)
+          return *handle;
+
+        // the text is laid out for the transformation of the contexts, which the tiles share up to a translation
+        pango_cairo_update_context(this->cairo_context, this->pango_context);
+
+        std::shared_ptr< text_handle > created(new text_handle(this->pango_context, text, anchor, font));
+        size_t const                   bytes = created->footprint();
+        return this->text_cache.insert(text, anchor, font, std::move(created), bytes);
+      }
+
+      /** flips the y axis of a context whose surface starts at the given row of the frame */
+      void setup(cairo_t* const context, int32_t const origin) const {
+        cairo_set_antialias(context, CAIRO_ANTIALIAS_SUBPIXEL);
+        cairo_scale(context, 1.0, -1.0);
+        cairo_translate(context, 0.0, origin - this->source_dimension.y);
+      }
+
+      /**
+       * Splits the surface in horizontal tiles sharing its pixels, one per thread of the shared pool if count is 0. With
+       * a single tile, the commands are drawn right away on the surface instead of being recorded.
+       */
+      void create_tiles(size_t count) {
+        if (count == 0)
+          count = utils::thread_pool::shared().size() + 1;
+
+        count = std::min(count, static_cast< size_t >(this->source_dimension.y));
+        if (count <= 1)
+          return;
+
+        uint8_t* const data   = cairo_image_surface_get_data(this->cairo_surface);
+        int const      stride = cairo_image_surface_get_stride(this->cairo_surface);
+        int32_t const  height = static_cast< int32_t >((this->source_dimension.y + count - 1) / count);
+
+        for (int32_t y = 0; y < this->source_dimension.y; y += height) {
+          tile tile;
+          tile.rows    = glm::ivec2(y, std::min(y + height, this->source_dimension.y));
+          tile.surface = cairo_image_surface_create_for_data(data + y * stride, CAIRO_FORMAT_ARGB32, this->source_dimension.x, tile.rows.y - tile.rows.x, stride);
+          tile.context = cairo_create(tile.surface);
+
+          this->setup(tile.context, y);
+          this->tiles.push_back(tile);
+        }
+
+        std::clog << "I: cairo renderer drawing in " << this->tiles.size() << " tiles" << std::endl;
+      }
+
+      /** the surface rows covered by the given vertical extent, in user coordinates, with some margin */
+      glm::ivec2 rows(float const top, float const bottom, float const margin) const {
+        float const first = this->source_dimension.y - std::max(top, bottom) - margin;
+        float const last  = this->source_dimension.y - std::min(top, bottom) + margin;
+
+        return glm::ivec2(static_cast< int32_t >(std::floor(first)), static_cast< int32_t >(std::ceil(last)) + 1);
+      }
+
+      /** draws the command right away, or records it for the tiles */
+      void submit(command&& command) {
+        if (this->tiles.empty()) {
+          this->draw(this->cairo_context, command);
+          this->points.clear();
+        } else {
+          this->commands.push_back(std::move(command));
+        }
+      }
+
+      void draw(cairo_t* const context, command const& command) const {
+        cairo_save(context);
+        cairo_set_source_rgba(context, command.color.x, command.color.y, command.color.z, command.color.w);
 
-        {
-          auto const& it = this->text_cache.find(key);
-          if (it != this->text_cache.end()) {
-            it->second.used = true;
-            return it->second;
+        if (command.text) {
+          cairo_translate(context, command.top_left.x, command.top_left.y);
+          for (auto const& run : command.text->runs) {
+            cairo_set_scaled_font(context, run.font);
+            cairo_show_glyphs(context, run.glyphs.data(), static_cast< int >(run.glyphs.size()));
           }
+        } else {
+          cairo_move_to(context, this->points[command.first].x, this->points[command.first].y);
+          for (size_t i = command.first + 1; i < command.first + command.count; ++i) {
+            cairo_line_to(context, this->points[i].x, this->points[i].y);
+          }
+          cairo_set_line_width(context, command.width);
+          cairo_set_line_cap(context, CAIRO_LINE_CAP_ROUND);
+          cairo_stroke(context);
         }
 
-        text_handle& handle = this->text_cache.insert(std::make_pair(key, text_handle(this->pango_context, text, anchor, font))).first->second;
+        cairo_restore(context);
+      }
+
+      /**
+       * Replays the recorded commands, every tile in parallel with the commands overlapping it, in the recorded order.
+       * The tiles only read the commands and the glyphs of the text, which have been laid out when recorded.
+       */
+      void replay() {
+        if (this->commands.empty())
+          return;
 
-        handle.used = true;
+        cairo_surface_flush(this->cairo_surface);
+        utils::thread_pool::shared().parallel_for(this->tiles.size(), [this](size_t const begin, size_t const end) {
+                                                    for (size_t i = begin; i < end; ++i) {
+                                                      tile const& tile = this->tiles[i];
+
+                                                      for (auto const& command : this->commands) {
+                                                        if ((command.rows.x < tile.rows.y) && (command.rows.y > tile.rows.x))
+                                                          this->draw(tile.context, command);
+                                                      }
+                                                      cairo_surface_flush(tile.surface);
+                                                    }
+                                                  }, 1);
+        cairo_surface_mark_dirty(this->cairo_surface);
+
+        this->commands.clear();
+        this->points.clear();
+      }
+
+      /**
+       * Uploads the frame to the screen texture and draws it as a single quad. The frame goes through two pixel buffers
+       * used in turn, so that the transfer to the texture goes on while the next frame is drawn, without waiting for the
+       * previous transfer to complete. Without pixel buffers, the frame is uploaded to the texture directly.
+       */
+      void present() {
+        gl_extensions const& gl     = gl_extensions::get();
+        size_t const         bytes  = cairo_image_surface_get_stride(this->cairo_surface) * this->source_dimension.y;
+        uint8_t const* const pixels = cairo_image_surface_get_data(this->cairo_surface);
+
+        if (!this->screen_texture) {
+          glGenTextures(1, &this->screen_texture);
+          glBindTexture(GL_TEXTURE_2D, this->screen_texture);
+          glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+          glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+          glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, this->source_dimension.x, this->source_dimension.y, 0, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+
+          if (gl.has_buffers())
+            gl.gen_buffers(2, this->pixel_buffers);
+        }
 
-        return handle;
-      } // make_text
+        glBindTexture(GL_TEXTURE_2D, this->screen_texture);
+
+        void* mapped = NULL;
+        if (this->pixel_buffers[0]) {
+          gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, this->pixel_buffers[this->pixel_buffer]);
+          gl.buffer_data(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+          mapped = gl.map_buffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+          this->pixel_buffer = (this->pixel_buffer + 1) % 2;
+        }
+
+        if (mapped) {
+          std::memcpy(mapped, pixels, bytes);
+          gl.unmap_buffer(GL_PIXEL_UNPACK_BUFFER);
+          glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->source_dimension.x, this->source_dimension.y, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+        } else {
+          glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->source_dimension.x, this->source_dimension.y, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
+        }
+
+        if (this->pixel_buffers[0])
+          gl.bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        // the first row of the frame is the bottom row of the screen
+        glm::vec2 const dimension = glm::vec2(this->source_dimension);
+
+        glEnable(GL_TEXTURE_2D);
+        glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+        glBegin(GL_QUADS);
+        glTexCoord2f(0.0f, 0.0f);
+        glVertex2f(0.0f, dimension.y);
+        glTexCoord2f(1.0f, 0.0f);
+        glVertex2f(dimension.x, dimension.y);
+        glTexCoord2f(1.0f, 1.0f);
+        glVertex2f(dimension.x, 0.0f);
+        glTexCoord2f(0.0f, 1.0f);
+        glVertex2f(0.0f, 0.0f);
+        glEnd();
+        glDisable(GL_TEXTURE_2D);
+      } // present
 
       glm::ivec2 const    source_dimension;
       PangoContext* const pango_context;
       cairo_surface_t*    cairo_surface;
       cairo_t*            cairo_context;
 
-      std::unordered_map< std::string, text_handle > text_cache;
+      renderer::text_cache< std::shared_ptr< text_handle > > text_cache;
+
+      std::vector< tile >      tiles;
+      std::vector< command >   commands;
+      std::vector< glm::vec2 > points;
+
+      /** reused buffer for the parameters the curves are evaluated at */
+      std::vector< float > curve_parameters;
+
+      /** the on screen texture, and the pixel buffers the frames are uploaded through */
+      GLuint screen_texture;
+      GLuint pixel_buffers[2];
+      size_t pixel_buffer;
+
+      /** whether the frame has changed since it was last presented */
+      bool changed;
     };
 
     namespace {
@@ -190,34 +467,36 @@ namespace logoprism {
     }
 
     void cairo::cleanup_cache() {
-      if (this->impl_ptr->text_cache.size() < 50)
-        return;
+      // the least recently used text is evicted as new text is cached
+    }
+
+    void cairo::clear_cache() {
+      auto& self = *this->impl_ptr;
+      self.text_cache.clear();
 
-      std::vector< std::string > unused;
+      // the window, and thus the GL context, is about to be created again, the texture and pixel buffers are released
+      // with the current context and are created again in the new one on the next present
+      if (self.pixel_buffers[0])
+        gl_extensions::get().delete_buffers(2, self.pixel_buffers);
 
-      for (auto& pair : this->impl_ptr->text_cache) {
-        if (pair.second.used)
-          pair.second.used = false;
-        else
-          unused.push_back(pair.first);
-      }
+      if (self.screen_texture)
+        glDeleteTextures(1, &self.screen_texture);
 
-      for (auto const& key : unused) {
-        this->impl_ptr->text_cache.erase(key);
-      }
+      self.screen_texture   = 0;
+      self.pixel_buffers[0] = 0;
+      self.pixel_buffers[1] = 0;
+      self.pixel_buffer     = 0;
     }
 
-    void cairo::clear_cache() {
-      this->impl_ptr->text_cache.clear();
+    renderer::cache_statistics cairo::text_cache_statistics() const {
+      return this->impl_ptr->text_cache.stats();
     }
 
     void cairo::erase() {
-      auto& self = *this->impl_ptr;
+      this->flush();
 
-      static bool const offscreen = config::get("display.offscreen");
-
-      if (!offscreen)
-        glDrawPixels(self.source_dimension.x, self.source_dimension.y, GL_BGRA, GL_UNSIGNED_BYTE, cairo_image_surface_get_data(self.cairo_surface));
+      auto& self = *this->impl_ptr;
+      self.changed = true;
 
       cairo_set_source_rgba(self.cairo_context, 0.0, 0.0, 0.0, 1.0);
       cairo_reset_clip(self.cairo_context);
@@ -228,58 +507,80 @@ namespace logoprism {
     glm::vec2 cairo::measure(std::string const& text, text::anchor const& anchor, std::string const& font) {
       auto const& handle = this->impl_ptr->make_text(text, anchor, font);
 
-      return glm::vec2(handle.dimensions);
+      return glm::vec2(handle->dimensions);
     }
 
-    void cairo::render(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color) {
+    void cairo::draw_text(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color) {
       auto&       self   = *this->impl_ptr;
       auto const& handle = self.make_text(text, anchor, font);
 
-      glm::vec2 const& dimensions = glm::vec2(handle.dimensions);
+      glm::vec2 const& dimensions = glm::vec2(handle->dimensions);
       glm::vec2 const& top_left   = position + alignment_ratio(anchor) * dimensions;
 
-      pango_cairo_update_context(self.cairo_context, self.pango_context);
-      pango_context_set_font_description(self.pango_context, handle.pango_font);
-
-      cairo_save(self.cairo_context);
-      cairo_move_to(self.cairo_context, top_left.x, top_left.y);
-      cairo_set_source_rgba(self.cairo_context, color.x, color.y, color.z, color.w);
-      pango_cairo_update_layout(self.cairo_context, handle.pango_layout);
-      pango_cairo_show_layout(self.cairo_context, handle.pango_layout);
-      cairo_restore(self.cairo_context);
+      impl::command command;
+      command.text     = handle;
+      command.top_left = top_left;
+      command.color    = color;
+      command.rows     = self.rows(top_left.y, top_left.y + dimensions.y, dimensions.y);
+      self.submit(std::move(command));
+      self.changed = true;
     }
 
-    void cairo::render(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const&, glm::vec4 const& color, double const width) {
+    void cairo::draw_curve(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width) {
       auto& self = *this->impl_ptr;
 
-      cairo_pattern_t* cairo_pattern = cairo_pattern_create_linear(std::get< 3 >(points).x, std::get< 3 >(points).y, std::get< 0 >(points).x, std::get< 0 >(points).y);
-
-      if ((range.y <= 0.0) || (range.x >= 1.0)) {
-        cairo_pattern_add_color_stop_rgba(cairo_pattern, 0.0, color.x, color.y, color.z, 0.0);
-        cairo_pattern_add_color_stop_rgba(cairo_pattern, 1.0, color.x, color.y, color.z, 0.0);
-      } else {
-        cairo_pattern_add_color_stop_rgba(cairo_pattern, range.y, color.x, color.y, color.z, color.w);
-        if (range.y < 1.0)
-          cairo_pattern_add_color_stop_rgba(cairo_pattern, std::min(1.0, range.y + 0.000001), color.x, color.y, color.z, 0.0);
+      float const curve_start = std::max(0.0f, range.x);
+      float const curve_end   = std::min(1.0f, range.y);
+      if (curve_end <= curve_start)
+        return;
 
-        cairo_pattern_add_color_stop_rgba(cairo_pattern, range.x, color.x, color.y, color.z, color.w);
-        if (range.x > 0.0)
-          cairo_pattern_add_color_stop_rgba(cairo_pattern, std::max(0.0, range.x - 0.000001), color.x, color.y, color.z, 0.0);
+      // only the visible range of the curve is stroked, as a polyline evaluated by the bezier kernel
+      static float const tolerance = config::get("display.curve-tolerance", 0.25);
+
+      auto& parameters = self.curve_parameters;
+      parameters.clear();
+      bezier_kernel::subdivide(points, glm::vec2(curve_start, curve_end), fading, tolerance, curve_segments - 1, parameters);
+      size_t const segment_count = parameters.size() - 1;
+
+      float x[curve_segments];
+      float y[curve_segments];
+      float alpha[curve_segments];
+      bezier_kernel::evaluate(points, parameters.data(), segment_count + 1, fading, x, y, alpha);
+
+      impl::command command;
+      command.first = self.points.size();
+      command.count = segment_count + 1;
+      command.width = width;
+      command.color = color;
+
+      float top    = y[0];
+      float bottom = y[0];
+      for (size_t i = 0; i <= segment_count; ++i) {
+        self.points.push_back(glm::vec2(x[i], y[i]));
+        top    = std::max(top, y[i]);
+        bottom = std::min(bottom, y[i]);
       }
+      command.rows = self.rows(top, bottom, static_cast< float >(width));
+
+      self.submit(std::move(command));
+      self.changed = true;
+    }
 
-      cairo_save(self.cairo_context);
-      cairo_move_to(self.cairo_context, std::get< 0 >(points).x, std::get< 0 >(points).y);
-      cairo_curve_to(self.cairo_context, std::get< 1 >(points).x, std::get< 1 >(points).y, std::get< 2 >(points).x, std::get< 2 >(points).y, std::get< 3 >(points).x, std::get< 3 >(points).y);
-      cairo_set_source(self.cairo_context, cairo_pattern);
-      cairo_set_line_width(self.cairo_context, width);
-      cairo_set_line_cap(self.cairo_context, CAIRO_LINE_CAP_ROUND);
-      cairo_stroke(self.cairo_context);
-      cairo_restore(self.cairo_context);
+    void cairo::commit() {
+      auto& self = *this->impl_ptr;
+      self.replay();
+
+      // if not rendering offscreen, the frame that has just been drawn is presented right away
+      static bool const offscreen = config::get("display.offscreen");
 
-      cairo_pattern_destroy(cairo_pattern);
+      if (!offscreen && self.changed)
+        self.present();
+      self.changed = false;
     }
 
     void cairo::read(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t* const& target) {
+      this->flush();
+
       auto&                 self        = *this->impl_ptr;
       uint32_t const* const source_data = reinterpret_cast< uint32_t const* >(cairo_image_surface_get_data(self.cairo_surface));
       uint32_t* const       target_data = reinterpret_cast< uint32_t* >(target);
@@ -291,6 +592,8 @@ namespace logoprism {
     }
 
     void cairo::write(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t const* const& source) {
+      this->flush();
+
       auto&                 self        = *this->impl_ptr;
       uint32_t* const       target_data = reinterpret_cast< uint32_t* >(cairo_image_surface_get_data(self.cairo_surface));
       uint32_t const* const source_data = reinterpret_cast< uint32_t const* >(source);
@@ -299,6 +602,8 @@ namespace logoprism {
       for (int32_t y = 0; y < dimension.y; ++y) {
         std::memcpy(target_data + (y + offset.y) * self.source_dimension.x + offset.x, source_data + y * dimension.x, dimension.x * sizeof(uint32_t));
       }
+      cairo_surface_mark_dirty(self.cairo_surface);
+      self.changed = true;
     }
 
   }
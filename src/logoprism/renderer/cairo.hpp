@@ -14,17 +14,23 @@ namespace logoprism {
       void cleanup_cache();
       void clear_cache();
 
+      renderer::cache_statistics text_cache_statistics() const;
+
       void erase();
 
       glm::vec2 measure(std::string const& text, text::anchor const& anchor, std::string const& font);
-      void      render(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color);
-
-      void render(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width);
 
       void read(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t* const& target);
 
       void write(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t const* const& source);
 
+      protected:
+        void draw_text(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color);
+
+        void draw_curve(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width);
+
+        void commit();
+
       private:
         struct impl;
 
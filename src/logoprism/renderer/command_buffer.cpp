@@ -0,0 +1,73 @@
+#include "logoprism/renderer/command_buffer.hpp"
+
+#include <algorithm>
+
+namespace logoprism {
+  namespace renderer {
+
+    command_buffer::command_buffer() :
+      string_count(0),
+      current_layer(0)
+    {}
+
+    void command_buffer::record(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color) {
+      // reuse the strings of the previous frames, and their capacity
+      if (this->string_count == this->strings.size())
+        this->strings.push_back(std::string());
+      this->strings[this->string_count].assign(text);
+
+      command& command = this->append(renderer::command::type::TEXT, color);
+      command.text     = static_cast< uint32_t >(this->string_count++);
+      command.font     = this->intern(font);
+      command.position = position;
+      command.anchor   = anchor;
+    }
+
+    void command_buffer::record(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width) {
+      command& command = this->append(renderer::command::type::CURVE, color);
+      command.points = points;
+      command.range  = range;
+      command.fading = fading;
+      command.width  = width;
+    }
+
+    void command_buffer::record(renderer::curve const& curve, glm::vec4 const& color, double const width) {
+      command& command = this->append(renderer::command::type::CURVE, color);
+      command.curve = &curve;
+      command.width = width;
+    }
+
+    void command_buffer::sort() {
+      std::sort(this->commands.begin(), this->commands.end(), [](command const& a, command const& b) { return a.key < b.key; });
+    }
+
+    void command_buffer::clear() {
+      this->commands.clear();
+      this->string_count  = 0;
+      this->current_layer = 0;
+    }
+
+    command& command_buffer::append(command::type const kind, glm::vec4 const& color) {
+      this->commands.push_back(command());
+
+      command& command = this->commands.back();
+      command.key   = (static_cast< uint64_t >(this->current_layer) << 32) | static_cast< uint64_t >(this->commands.size() - 1);
+      command.kind  = kind;
+      command.color = color;
+      command.curve = nullptr;
+
+      return command;
+    }
+
+    uint32_t command_buffer::intern(std::string const& font) {
+      for (size_t i = 0; i < this->fonts.size(); ++i) {
+        if (this->fonts[i] == font)
+          return static_cast< uint32_t >(i);
+      }
+
+      this->fonts.push_back(font);
+      return static_cast< uint32_t >(this->fonts.size() - 1);
+    }
+
+  }
+}
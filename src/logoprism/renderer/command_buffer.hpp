@@ -0,0 +1,89 @@
+#ifndef __LOGOPRISM_RENDERER_COMMAND_BUFFER_HPP__
+#define __LOGOPRISM_RENDERER_COMMAND_BUFFER_HPP__
+
+#include "logoprism/renderer/renderer.hpp"
+
+#include <string>
+#include <vector>
+
+namespace logoprism {
+  namespace renderer {
+
+    /** a text or curve drawing command of a frame */
+    struct command {
+      enum class type {
+        TEXT,
+        CURVE,
+      };
+
+      /** the commands are drawn by increasing sort key, the layer in the high bits and the recording order in the low bits */
+      uint64_t key;
+      type     kind;
+
+      glm::vec4 color;
+
+      /** the text, its font and its anchor, as indexes in the command buffer strings and fonts */
+      uint32_t     text;
+      uint32_t     font;
+      glm::vec2    position;
+      text::anchor anchor;
+
+      /** the curve, either a view curve with its cached tessellation or only its control points */
+      renderer::curve const*                                     curve;
+      std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > points;
+      glm::vec2                                                  range;
+      glm::vec2                                                  fading;
+      double                                                     width;
+    };
+
+    /**
+     * List of the drawing commands of a frame, recorded by the views and consumed at once by the renderers.
+     *
+     * The text of the commands is copied in strings kept from one frame to the other, so that recording a frame does not
+     * allocate once the buffer has grown. The view curves are referenced and must outlive the frame.
+     */
+    struct command_buffer {
+      public:
+        typedef std::vector< command >::const_iterator const_iterator;
+
+        command_buffer();
+
+        /** the layer of the commands recorded from now on, the higher layers are drawn over the lower ones */
+        void     layer(uint16_t const layer) { this->current_layer = layer; }
+        uint16_t layer() const { return this->current_layer; }
+
+        void record(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color);
+        void record(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width);
+        void record(renderer::curve const& curve, glm::vec4 const& color, double const width);
+
+        /** sorts the commands by sort key, keeping the recording order within a layer */
+        void sort();
+
+        /** discards the commands, keeping the strings for the next frame, and goes back to the first layer */
+        void clear();
+
+        std::string const& text(command const& command) const { return this->strings[command.text]; }
+        std::string const& font(command const& command) const { return this->fonts[command.font]; }
+
+        const_iterator begin() const { return this->commands.begin(); }
+        const_iterator end() const { return this->commands.end(); }
+        size_t         size() const { return this->commands.size(); }
+        bool           empty() const { return this->commands.empty(); }
+
+      protected:
+        std::vector< command >     commands;
+        std::vector< std::string > strings;
+        size_t                     string_count;
+        std::vector< std::string > fonts;
+        uint16_t                   current_layer;
+
+        command& append(command::type const kind, glm::vec4 const& color);
+
+        /** the index of a font, there are only a few of them so they are compared one by one */
+        uint32_t intern(std::string const& font);
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_RENDERER_COMMAND_BUFFER_HPP__
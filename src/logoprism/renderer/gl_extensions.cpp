@@ -0,0 +1,27 @@
+#include "logoprism/renderer/gl_extensions.hpp"
+
+namespace logoprism {
+  namespace renderer {
+
+    gl_extensions::gl_extensions() :
+      gen_buffers((PFNGLGENBUFFERSPROC) glfwGetProcAddress("glGenBuffers")),
+      delete_buffers((PFNGLDELETEBUFFERSPROC) glfwGetProcAddress("glDeleteBuffers")),
+      bind_buffer((PFNGLBINDBUFFERPROC) glfwGetProcAddress("glBindBuffer")),
+      buffer_data((PFNGLBUFFERDATAPROC) glfwGetProcAddress("glBufferData")),
+      buffer_sub_data((PFNGLBUFFERSUBDATAPROC) glfwGetProcAddress("glBufferSubData")),
+      map_buffer((PFNGLMAPBUFFERPROC) glfwGetProcAddress("glMapBuffer")),
+      unmap_buffer((PFNGLUNMAPBUFFERPROC) glfwGetProcAddress("glUnmapBuffer")),
+      window_pos_2iv((PFNGLWINDOWPOS2IVPROC) glfwGetProcAddress("glWindowPos2iv")),
+      fence_sync((PFNGLFENCESYNCPROC) glfwGetProcAddress("glFenceSync")),
+      delete_sync((PFNGLDELETESYNCPROC) glfwGetProcAddress("glDeleteSync")),
+      client_wait_sync((PFNGLCLIENTWAITSYNCPROC) glfwGetProcAddress("glClientWaitSync"))
+    {}
+
+    gl_extensions const& gl_extensions::get() {
+      static gl_extensions const extensions;
+
+      return extensions;
+    }
+
+  }
+}
@@ -0,0 +1,50 @@
+#ifndef __LOGOPRISM_RENDERER_GL_EXTENSIONS_HPP__
+#define __LOGOPRISM_RENDERER_GL_EXTENSIONS_HPP__
+
+#include <GLFW/glfw3.h>
+#include <GL/glext.h>
+
+namespace logoprism {
+  namespace renderer {
+
+    /**
+     * Entry points of the OpenGL functions that are not exported by the system OpenGL library, loaded once through GLFW.
+     * The functions are null when the driver does not provide them, and their users fall back to older code paths.
+     */
+    struct gl_extensions {
+      public:
+        /** the entry points, loaded on first call, which requires a current OpenGL context */
+        static gl_extensions const& get();
+
+        /** whether vertex and pixel buffer objects are available */
+        bool has_buffers() const {
+          return this->gen_buffers && this->delete_buffers && this->bind_buffer && this->buffer_data && this->buffer_sub_data
+                 && this->map_buffer && this->unmap_buffer;
+        }
+
+        PFNGLGENBUFFERSPROC    gen_buffers;
+        PFNGLDELETEBUFFERSPROC delete_buffers;
+        PFNGLBINDBUFFERPROC    bind_buffer;
+        PFNGLBUFFERDATAPROC    buffer_data;
+        PFNGLBUFFERSUBDATAPROC buffer_sub_data;
+        PFNGLMAPBUFFERPROC     map_buffer;
+        PFNGLUNMAPBUFFERPROC   unmap_buffer;
+        PFNGLWINDOWPOS2IVPROC  window_pos_2iv;
+
+        /** whether fence sync objects are available */
+        bool has_sync() const {
+          return this->fence_sync && this->delete_sync && this->client_wait_sync;
+        }
+
+        PFNGLFENCESYNCPROC      fence_sync;
+        PFNGLDELETESYNCPROC     delete_sync;
+        PFNGLCLIENTWAITSYNCPROC client_wait_sync;
+
+      protected:
+        gl_extensions();
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_RENDERER_GL_EXTENSIONS_HPP__
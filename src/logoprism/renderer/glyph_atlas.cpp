@@ -0,0 +1,336 @@
+#include "logoprism/renderer/glyph_atlas.hpp"
+
+#include <cairo/cairo.h>
+#include <pango/pango.h>
+#include <pango/pango-layout.h>
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+namespace logoprism {
+  namespace renderer {
+
+    namespace {
+
+      /** spacing between the glyphs in the atlas, so that linear filtering does not bleed from one glyph to another */
+      static int32_t const glyph_padding = 1;
+
+      /** decodes the UTF-8 sequence at the given position, moving past it, invalid bytes are decoded one by one */
+      static uint32_t next_codepoint(char const*& it, char const* const end) {
+        uint8_t const lead = static_cast< uint8_t >(*it++);
+
+        size_t   length    = 0;
+        uint32_t codepoint = lead;
+        if ((lead & 0xE0) == 0xC0) {
+          length    = 1;
+          codepoint = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+          length    = 2;
+          codepoint = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+          length    = 3;
+          codepoint = lead & 0x07;
+        }
+
+        for (size_t i = 0; i < length && it != end && (static_cast< uint8_t >(*it) & 0xC0) == 0x80; ++i) {
+          codepoint = (codepoint << 6) | (static_cast< uint8_t >(*it++) & 0x3F);
+        }
+
+        return codepoint;
+      }
+
+    }
+
+    /** a pango layout for a font, used to measure and rasterize its glyphs one at a time */
+    struct glyph_atlas::face {
+      face(std::string const& font) :
+        surface(cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1)),
+        context(cairo_create(surface)),
+        layout(pango_cairo_create_layout(context)),
+        description(pango_font_description_from_string(font.c_str())),
+        line_height(0.0f),
+        char_width(0.0f) {
+        cairo_font_options_t* const font_options = cairo_font_options_create();
+        cairo_font_options_set_antialias(font_options, CAIRO_ANTIALIAS_GRAY);
+        cairo_font_options_set_hint_style(font_options, CAIRO_HINT_STYLE_FULL);
+        cairo_font_options_set_hint_metrics(font_options, CAIRO_HINT_METRICS_ON);
+
+        pango_cairo_context_set_font_options(pango_layout_get_context(this->layout), font_options);
+        cairo_font_options_destroy(font_options);
+
+        pango_layout_set_font_description(this->layout, this->description);
+        pango_layout_context_changed(this->layout);
+
+        PangoRectangle logical;
+        pango_layout_set_text(this->layout, "M", -1);
+        pango_layout_get_pixel_extents(this->layout, NULL, &logical);
+        this->line_height = static_cast< float >(logical.height);
+        this->char_width  = static_cast< float >(logical.width);
+      }
+
+      ~face() {
+        g_object_unref(this->layout);
+        pango_font_description_free(this->description);
+        cairo_destroy(this->context);
+        cairo_surface_destroy(this->surface);
+      }
+
+      cairo_surface_t* const      surface;
+      cairo_t* const              context;
+      PangoLayout* const          layout;
+      PangoFontDescription* const description;
+      float                       line_height;
+      float                       char_width;
+
+      std::unordered_map< uint32_t, glyph_atlas::glyph > glyphs;
+
+      /** the rasterized glyphs, kept when the atlas is cleared so that they are added back without rasterizing them again */
+      std::unordered_map< uint32_t, glyph_atlas::bitmap > bitmaps;
+
+      /** the glyphs being rasterized in the background */
+      std::unordered_set< uint32_t > pending;
+    };
+
+    glyph_atlas::glyph_atlas(glm::ivec2 const& dimension, bool const asynchronous) :
+      size(dimension),
+      image(dimension.x * dimension.y, 0),
+      dirty_rows(0, dimension.y),
+      generation_count(0),
+      overflow(false),
+      cursor(glyph_padding, glyph_padding),
+      row_height(0),
+      rasterizer(asynchronous ? new utils::thread_pool(1) : nullptr)
+    {}
+
+    glyph_atlas::~glyph_atlas() {
+      this->rasterizer.reset();
+    }
+
+    glm::vec2 glyph_atlas::measure(std::string const& text, std::string const& font) {
+      face& face = this->get_face(this->faces, font);
+
+      float       width = 0.0f;
+      char const* end   = text.data() + text.size();
+      for (char const* it = text.data(); it != end;) {
+        char const* const  bytes     = it;
+        uint32_t const     codepoint = next_codepoint(it, end);
+        glyph const* const glyph     = this->get_glyph(face, font, codepoint, bytes, it - bytes);
+
+        width += glyph ? glyph->advance : face.char_width;
+      }
+
+      return glm::vec2(width, face.line_height);
+    }
+
+    glm::vec2 glyph_atlas::layout(std::string const& text, glm::vec2 const& top_left, std::string const& font, std::vector< quad >& quads, bool* const complete) {
+      face&           face  = this->get_face(this->faces, font);
+      glm::vec2 const scale = glm::vec2(1.0f / this->size.x, 1.0f / this->size.y);
+
+      if (complete)
+        *complete = true;
+
+      glm::vec2   pen = top_left;
+      char const* end = text.data() + text.size();
+      for (char const* it = text.data(); it != end;) {
+        char const* const  bytes     = it;
+        uint32_t const     codepoint = next_codepoint(it, end);
+        glyph const* const glyph     = this->get_glyph(face, font, codepoint, bytes, it - bytes);
+
+        // the glyphs still being rasterized take the approximate character width, and are not drawn yet
+        if (!glyph) {
+          if (complete)
+            *complete = false;
+
+          pen.x += face.char_width;
+          continue;
+        }
+
+        if ((glyph->extent.x > 0) && (glyph->extent.y > 0)) {
+          quad q;
+          q.top_left             = pen + glm::vec2(glyph->bearing);
+          q.bottom_right         = q.top_left + glm::vec2(glyph->extent);
+          q.texture_top_left     = glm::vec2(glyph->origin) * scale;
+          q.texture_bottom_right = glm::vec2(glyph->origin + glyph->extent) * scale;
+          quads.push_back(q);
+        }
+
+        pen.x += glyph->advance;
+      }
+
+      return glm::vec2(pen.x - top_left.x, face.line_height);
+    } // layout
+
+    void glyph_atlas::update() {
+      if (!this->rasterizer)
+        return;
+
+      std::vector< bitmap > ready;
+      {
+        boost::lock_guard< boost::mutex > lock(this->ready_mutex);
+        std::swap(ready, this->ready);
+      }
+
+      for (auto& bitmap : ready) {
+        face& face = this->get_face(this->faces, bitmap.font);
+
+        face.pending.erase(bitmap.codepoint);
+        auto const& kept = face.bitmaps.insert(std::make_pair(bitmap.codepoint, std::move(bitmap))).first->second;
+        if (face.glyphs.find(kept.codepoint) == face.glyphs.end())
+          this->store(face, kept);
+      }
+    }
+
+    void glyph_atlas::clear() {
+      for (auto& pair : this->faces) {
+        pair.second->glyphs.clear();
+      }
+
+      std::fill(this->image.begin(), this->image.end(), 0);
+      this->dirty_rows        = glm::ivec2(0, this->size.y);
+      this->cursor            = glm::ivec2(glyph_padding, glyph_padding);
+      this->row_height        = 0;
+      this->overflow          = false;
+      this->generation_count += 1;
+    }
+
+    glyph_atlas::face& glyph_atlas::get_face(faces_t& faces, std::string const& font) {
+      auto it = faces.find(font);
+      if (it == faces.end())
+        it = faces.insert(std::make_pair(font, std::unique_ptr< face >(new face(font)))).first;
+
+      return *it->second;
+    }
+
+    glyph_atlas::glyph const* glyph_atlas::get_glyph(face& face, std::string const& font, uint32_t const codepoint, char const* const bytes, size_t const length) {
+      {
+        auto const it = face.glyphs.find(codepoint);
+        if (it != face.glyphs.end())
+          return &it->second;
+      }
+
+      // the glyph would not fit anyway, until the atlas is cleared
+      if (this->overflow)
+        return nullptr;
+
+      // the glyphs discarded by a clear are added back from their kept bitmap
+      {
+        auto const it = face.bitmaps.find(codepoint);
+        if (it != face.bitmaps.end())
+          return this->store(face, it->second);
+      }
+
+      if (!this->rasterizer) {
+        bitmap bitmap;
+        glyph_atlas::rasterize(face, bytes, length, bitmap);
+        bitmap.font      = font;
+        bitmap.codepoint = codepoint;
+
+        return this->store(face, face.bitmaps.insert(std::make_pair(codepoint, std::move(bitmap))).first->second);
+      }
+
+      // rasterize the glyph in the background, once
+      if (face.pending.insert(codepoint).second) {
+        std::string const sequence(bytes, length);
+
+        this->rasterizer->post([this, font, codepoint, sequence]() {
+                                 bitmap bitmap;
+                                 bitmap.font      = font;
+                                 bitmap.codepoint = codepoint;
+                                 glyph_atlas::rasterize(this->get_face(this->rasterizer_faces, font), sequence.data(), sequence.size(), bitmap);
+
+                                 boost::lock_guard< boost::mutex > lock(this->ready_mutex);
+                                 this->ready.push_back(std::move(bitmap));
+                               });
+      }
+
+      return nullptr;
+    } // get_glyph
+
+    void glyph_atlas::rasterize(face& face, char const* const bytes, size_t const length, bitmap& bitmap) {
+      PangoRectangle ink;
+      PangoRectangle logical;
+      pango_layout_set_text(face.layout, bytes, static_cast< int >(length));
+      pango_layout_get_pixel_extents(face.layout, &ink, &logical);
+
+      bitmap.extent  = glm::ivec2(std::max(0, ink.width), std::max(0, ink.height));
+      bitmap.bearing = glm::ivec2(ink.x - logical.x, ink.y - logical.y);
+      bitmap.advance = static_cast< float >(logical.width);
+
+      if ((bitmap.extent.x == 0) || (bitmap.extent.y == 0))
+        return;
+
+      // rasterize the glyph alone, and keep its coverage
+      cairo_surface_t* const surface = cairo_image_surface_create(CAIRO_FORMAT_A8, ink.width, ink.height);
+      cairo_t* const         context = cairo_create(surface);
+
+      cairo_move_to(context, -ink.x, -ink.y);
+      pango_cairo_update_layout(context, face.layout);
+      pango_cairo_show_layout(context, face.layout);
+      cairo_surface_flush(surface);
+
+      uint8_t const* const source = cairo_image_surface_get_data(surface);
+      int const            stride = cairo_image_surface_get_stride(surface);
+
+      bitmap.coverage.resize(ink.width * ink.height);
+      for (int32_t y = 0; y < ink.height; ++y) {
+        std::copy(source + y * stride, source + y * stride + ink.width, bitmap.coverage.begin() + y * ink.width);
+      }
+
+      cairo_destroy(context);
+      cairo_surface_destroy(surface);
+    } // rasterize
+
+    glyph_atlas::glyph const* glyph_atlas::store(face& face, bitmap const& bitmap) {
+      glyph glyph;
+      glyph.origin  = glm::ivec2(0, 0);
+      glyph.extent  = glm::ivec2(0, 0);
+      glyph.bearing = bitmap.bearing;
+      glyph.advance = bitmap.advance;
+
+      // glyphs larger than the image are kept blank
+      bool const fits = (bitmap.extent.x + 2 * glyph_padding <= this->size.x) && (bitmap.extent.y + 2 * glyph_padding <= this->size.y);
+      if (!bitmap.coverage.empty() && fits) {
+        if (!this->allocate(bitmap.extent, glyph.origin))
+          return nullptr;
+
+        glyph.extent = bitmap.extent;
+
+        for (int32_t y = 0; y < glyph.extent.y; ++y) {
+          std::copy(bitmap.coverage.begin() + y * glyph.extent.x, bitmap.coverage.begin() + (y + 1) * glyph.extent.x,
+                    this->image.begin() + (glyph.origin.y + y) * this->size.x + glyph.origin.x);
+        }
+
+        this->dirty_rows.x = std::min(this->dirty_rows.x, glyph.origin.y);
+        this->dirty_rows.y = std::max(this->dirty_rows.y, glyph.origin.y + glyph.extent.y);
+      }
+
+      return &face.glyphs.insert(std::make_pair(bitmap.codepoint, glyph)).first->second;
+    }
+
+    bool glyph_atlas::allocate(glm::ivec2 const& extent, glm::ivec2& origin) {
+      // start a new row when the current one is full
+      if (this->cursor.x + extent.x + glyph_padding > this->size.x) {
+        this->cursor     = glm::ivec2(glyph_padding, this->cursor.y + this->row_height + glyph_padding);
+        this->row_height = 0;
+      }
+
+      // the glyphs already laid out may not have been drawn yet, the atlas is only cleared by its user
+      if (this->cursor.y + extent.y + glyph_padding > this->size.y) {
+        if (!this->overflow)
+          std::clog << "I: glyph atlas is full, discarding every glyph" << std::endl;
+
+        this->overflow = true;
+        return false;
+      }
+
+      origin           = this->cursor;
+      this->cursor.x  += extent.x + glyph_padding;
+      this->row_height = std::max(this->row_height, extent.y);
+
+      return true;
+    }
+
+  }
+}
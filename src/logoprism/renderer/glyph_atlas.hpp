@@ -0,0 +1,144 @@
+#ifndef __LOGOPRISM_RENDERER_GLYPH_ATLAS_HPP__
+#define __LOGOPRISM_RENDERER_GLYPH_ATLAS_HPP__
+
+#include "logoprism/data/types.hpp"
+#include "logoprism/utils/thread_pool.hpp"
+
+#include <boost/thread.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace logoprism {
+  namespace renderer {
+
+    /**
+     * Cache of rasterized glyphs, packed in rows into a single 8bit coverage image, so that any text can be drawn as a list
+     * of textured quads without rendering the whole string again.
+     *
+     * The glyphs are rasterized once per font, on first use, and the text is laid out from the cached glyph advances,
+     * which is exact for the monospace fonts used by the views. When the image is full, the glyphs that do not fit are laid
+     * out as missing, and the atlas is marked as full. It is then up to the user to clear it once the quads laid out so far
+     * have been drawn. The rasterized glyphs are kept by their font, so that they are only copied back to the image as they
+     * are used again, rather than rasterized again.
+     *
+     * When asynchronous, the missing glyphs are rasterized by a background thread and added to the image by update(). In
+     * the meantime, they are laid out with the approximate character width of their font, and are not drawn.
+     */
+    struct glyph_atlas {
+      public:
+        /** a glyph of the text, with its position on screen and in the atlas image, both as top left and bottom right corners */
+        struct quad {
+          glm::vec2 top_left;
+          glm::vec2 bottom_right;
+          glm::vec2 texture_top_left;
+          glm::vec2 texture_bottom_right;
+        };
+
+        /**
+         * Creates a new empty glyph atlas.
+         * @param dimension    the size of the atlas image, in pixels
+         * @param asynchronous whether to rasterize the glyphs in a background thread
+         */
+        glyph_atlas(glm::ivec2 const& dimension=glm::ivec2(1024, 1024), bool const asynchronous=false);
+        ~glyph_atlas();
+
+        /** the number of pixels the text would take with the given font */
+        glm::vec2 measure(std::string const& text, std::string const& font);
+
+        /**
+         * Lays the text out, rasterizing its missing glyphs, and appends one quad per visible glyph.
+         * @param  text     the text to lay out
+         * @param  top_left the position of the top left corner of the text
+         * @param  font     the pango font description of the text
+         * @param  quads    the quads to append the glyphs to, with texture coordinates normalized to the atlas size
+         * @param  complete set to whether every glyph of the text was ready, if not null
+         * @return          the number of pixels the text takes
+         */
+        glm::vec2 layout(std::string const& text, glm::vec2 const& top_left, std::string const& font, std::vector< quad >& quads, bool* const complete=NULL);
+
+        /** adds the glyphs rasterized in the background since the last update to the image */
+        void update();
+
+        /** discards every glyph */
+        void clear();
+
+        /** whether some glyph did not fit in the image since the last clear */
+        bool full() const { return this->overflow; }
+
+        /** how many times the glyphs have been discarded, the quads laid out before that are not valid anymore */
+        uint64_t generation() const { return this->generation_count; }
+
+        /** the coverage image, one byte per pixel, with rows of dimension().x bytes */
+        uint8_t const*    pixels() const { return this->image.data(); }
+        glm::ivec2 const& dimension() const { return this->size; }
+
+        /** the rows of the image that have changed since the last call to clean(), as [first, last) */
+        bool       dirty() const { return this->dirty_rows.x < this->dirty_rows.y; }
+        glm::ivec2 dirty_range() const { return this->dirty_rows; }
+        void       clean() { this->dirty_rows = glm::ivec2(this->size.y, 0); }
+
+      protected:
+        struct glyph {
+          /** the position and size of the glyph image in the atlas, empty for blank glyphs */
+          glm::ivec2 origin;
+          glm::ivec2 extent;
+
+          /** the offset of the glyph image from the top left corner of the glyph cell */
+          glm::ivec2 bearing;
+          float      advance;
+        };
+
+        /** a rasterized glyph, kept so that it can be added to the image again */
+        struct bitmap {
+          std::string            font;
+          uint32_t               codepoint;
+          glm::ivec2             extent;
+          glm::ivec2             bearing;
+          float                  advance;
+          std::vector< uint8_t > coverage;
+        };
+
+        struct face;
+
+        typedef std::unordered_map< std::string, std::unique_ptr< face > > faces_t;
+
+        glm::ivec2             size;
+        std::vector< uint8_t > image;
+        glm::ivec2             dirty_rows;
+        uint64_t               generation_count;
+        bool                   overflow;
+
+        /** the packing cursor, and the height of the current row of glyphs */
+        glm::ivec2 cursor;
+        int32_t    row_height;
+
+        faces_t faces;
+
+        /** the faces of the rasterizing thread, only used by it, and the glyphs it has rasterized */
+        faces_t               rasterizer_faces;
+        boost::mutex          ready_mutex;
+        std::vector< bitmap > ready;
+
+        /** declared last, so that the rasterizing thread is stopped first */
+        std::unique_ptr< utils::thread_pool > rasterizer;
+
+        face&        get_face(faces_t& faces, std::string const& font);
+        glyph const* get_glyph(face& face, std::string const& font, uint32_t const codepoint, char const* const bytes, size_t const length);
+
+        /** rasterizes a glyph with the given face, which must only be used by the calling thread */
+        static void rasterize(face& face, char const* const bytes, size_t const length, bitmap& bitmap);
+
+        /** adds a rasterized glyph to the image and to its face, or returns null if it does not fit in the image */
+        glyph const* store(face& face, bitmap const& bitmap);
+
+        /** reserves some space in the image for a glyph, marking the atlas as full if there is no room left */
+        bool allocate(glm::ivec2 const& extent, glm::ivec2& origin);
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_RENDERER_GLYPH_ATLAS_HPP__
@@ -1,106 +1,128 @@
 #include "logoprism/renderer/opengl.hpp"
+#include "logoprism/renderer/command_buffer.hpp"
+#include "logoprism/renderer/glyph_atlas.hpp"
+#include "logoprism/renderer/gl_extensions.hpp"
+#include "logoprism/renderer/bezier_kernel.hpp"
+#include "logoprism/renderer/text_cache.hpp"
 #include "logoprism/view/object.hpp"
+#include "logoprism/config/config.hpp"
 
 #include <GL/glext.h>
 
-#include <cairo/cairo.h>
-#include <pango/pango.h>
-#include <pango/pango-layout.h>
-#include <pango/pangocairo.h>
-
-#include <unordered_map>
-
-static PFNGLGENERATEMIPMAPPROC __glGenerateMipmap = 0;
-static PFNGLWINDOWPOS2IVPROC   __glWindowPos2iv   = 0;
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <iostream>
 
 namespace logoprism {
   namespace renderer {
 
     namespace {
 
-      template< size_t const EndOffset = 3, size_t const BeginOffset = 0 >
-      struct bezier_impl {
-        static inline glm::vec2 compute(float const position, std::vector< glm::vec2 > const& points) {
-          return bezier_impl< EndOffset - 1, BeginOffset >::compute(position, points) * (position)
-                 + bezier_impl< EndOffset, BeginOffset + 1 >::compute(position, points) * (1.0f - position);
-        }
+      /** number of curve points evaluated at once by the bezier kernel */
+      static size_t const tessellation_chunk = 64;
 
-      };
+      /** maximum number of segments of a tessellated curve */
+      static size_t const tessellation_limit = 256;
 
-      template< size_t const BeginOffset >
-      struct bezier_impl< BeginOffset, BeginOffset > {
-        static inline glm::vec2 compute(float const, std::vector< glm::vec2 > const& points) { return points[BeginOffset]; }
-      };
-
-#ifdef _WIN32
-      static void cairo_image_surface_blur(cairo_surface_t* surface, double radius) {
-        // Steve Hanov, 2009
-        // Released into the public domain.
-
-        // get width, height
-        int            width   = cairo_image_surface_get_width(surface);
-        int            height  = cairo_image_surface_get_height(surface);
-        unsigned char* dst     = (unsigned char*) malloc(width * height * 4);
-        unsigned*      precalc =
-          (unsigned*) malloc(width * height * sizeof(unsigned));
-        unsigned char* src = cairo_image_surface_get_data(surface);
-        double         mul = 1.f / ((radius * 2) * (radius * 2));
-        int            channel;
-
-        // The number of times to perform the averaging. According to wikipedia,
-        // three iterations is good enough to pass for a gaussian.
-        const size_t MAX_ITERATIONS = 3;
-        size_t       iteration;
-
-        memcpy(dst, src, width * height * 4);
-
-        for (iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
-          for (channel = 0; channel < 4; channel++) {
-            int x, y;
-
-            // precomputation step.
-            unsigned char* pix = src;
-            unsigned*      pre = precalc;
-
-            pix += channel;
-            for (y = 0; y < height; y++) {
-              for (x = 0; x < width; x++) {
-                int tot = pix[0];
-                if (x > 0)
-                  tot += pre[-1];
-                if (y > 0)
-                  tot += pre[-width];
-                if ((x > 0) && (y > 0))
-                  tot -= pre[-width - 1];
-                *pre++ = tot;
-                pix   += 4;
-              }
-            }
-
-            // blur step.
-            pix = dst + (int) radius * width * 4 + (int) radius * 4 + channel;
-            for (y = radius; y < height - radius; y++) {
-              for (x = radius; x < width - radius; x++) {
-                int l   = x < radius ? 0 : x - radius;
-                int t   = y < radius ? 0 : y - radius;
-                int r   = x + radius >= width ? width - 1 : x + radius;
-                int b   = y + radius >= height ? height - 1 : y + radius;
-                int tot = precalc[r + b * width] + precalc[l + t * width] -
-                          precalc[l + b * width] - precalc[r + t * width];
-                *pix = (unsigned char) (tot * mul);
-                pix += 4;
-              }
-              pix += (int) radius * 2 * 4;
+      /**
+       * Tessellates the bezier curve as pairs of (x, y, fading) line vertices, with as many segments as needed for the
+       * polyline to stay within the tolerance of the curve, in pixels.
+       */
+      static void tessellate(renderer::curve::control_points_type const& points, glm::vec2 const& range, glm::vec2 const& fading, float const tolerance,
+                             std::vector< float >& parameters, std::vector< glm::vec3 >& vertices) {
+        parameters.clear();
+        bezier_kernel::subdivide(points, range, fading, tolerance, tessellation_limit, parameters);
+
+        float x[tessellation_chunk];
+        float y[tessellation_chunk];
+        float alpha[tessellation_chunk];
+
+        vertices.reserve(vertices.size() + 2 * (parameters.size() - 1));
+
+        // evaluate the points by chunks, and emit the consecutive points as pairs
+        glm::vec3 prev;
+        for (size_t begin = 0; begin < parameters.size(); begin += tessellation_chunk) {
+          size_t const count = std::min(tessellation_chunk, parameters.size() - begin);
+          bezier_kernel::evaluate(points, parameters.data() + begin, count, fading, x, y, alpha);
+
+          for (size_t i = 0; i < count; ++i) {
+            glm::vec3 const next = glm::vec3(x[i], y[i], alpha[i]);
+            if (begin + i > 0) {
+              vertices.push_back(prev);
+              vertices.push_back(next);
             }
+            prev = next;
           }
-          memcpy(src, dst, width * height * 4);
         }
+      } // tessellate
 
-        free(dst);
-        free(precalc);
-      } // cairo_image_surface_blur
+      /** a vertex of the thick curves triangle strip */
+      struct line_vertex {
+        line_vertex(glm::vec2 const& position, glm::vec4 const& color) : position(position), color(color) {}
 
-#endif // ifdef _WIN32
+        glm::vec2 position;
+        glm::vec4 color;
+      };
+
+      /**
+       * Appends pairs of (x, y, fading) line vertices as triangle strips of the given color and width, joined to the
+       * previous curves of the strip with degenerate triangles.
+       *
+       * The curve is antialiased with a one pixel wide fringe on each side, fading from the curve color to transparent
+       * across the edge. Thinner curves are drawn one pixel wide with their color faded by their width, so that they keep
+       * about the same coverage.
+       */
+      static void append_strip(std::vector< glm::vec3 > const& vertices, glm::vec4 const& color, double const width, std::vector< line_vertex >& strip) {
+        if (vertices.empty())
+          return;
+
+        float const  coverage    = static_cast< float >(std::min(1.0, width));
+        float const  half_width  = static_cast< float >(std::max(1.0, width)) / 2.0f;
+        float const  inner       = half_width - 0.5f;
+        float const  outer       = half_width + 0.5f;
+        size_t const point_count = vertices.size() / 2 + 1;
+
+        // the line vertices come in pairs of consecutive points, the polyline is the first point of each pair plus the last one
+        auto const point = [&](size_t const i) -> glm::vec3 const& {
+                             return (i + 1 < point_count) ? vertices[2 * i] : vertices.back();
+                           };
+        auto const position = [&](size_t const i) -> glm::vec2 {
+                                return glm::vec2(point(i).x, point(i).y);
+                              };
+        auto const normal = [&](size_t const i) -> glm::vec2 {
+                              glm::vec2 const direction = position(i + 1 < point_count ? i + 1 : i) - position(i > 0 ? i - 1 : i);
+                              float const     length    = glm::length(direction);
+                              if (length > 0.0f)
+                                return glm::vec2(-direction.y, direction.x) / length;
+
+                              return glm::vec2(0.0f, 0.0f);
+                            };
+
+        // a band of the curve between two offsets along its normal, with the color opacity at each offset
+        auto const band = [&](float const from, float const from_opacity, float const to, float const to_opacity) {
+                            for (size_t i = 0; i < point_count; ++i) {
+                              glm::vec2 const p       = position(i);
+                              glm::vec2 const n       = normal(i);
+                              float const     opacity = color.w * coverage * point(i).z;
+
+                              line_vertex const first(p + n * from, glm::vec4(color.x, color.y, color.z, opacity * from_opacity));
+                              if ((i == 0) && !strip.empty()) {
+                                strip.push_back(strip.back());
+                                strip.push_back(first);
+                              }
+
+                              strip.push_back(first);
+                              strip.push_back(line_vertex(p + n * to, glm::vec4(color.x, color.y, color.z, opacity * to_opacity)));
+                            }
+                          };
+
+        strip.reserve(strip.size() + 3 * (2 * point_count + 2));
+        band(-outer, 0.0f, -inner, 1.0f);
+        if (inner > 0.0f)
+          band(-inner, 1.0f, inner, 1.0f);
+        band(inner, 1.0f, outer, 0.0f);
+      } // append_strip
 
       static glm::vec2 alignment_ratio(text::anchor const& anchor) {
         switch (anchor) {
@@ -137,168 +159,238 @@ namespace logoprism {
     }
 
     struct opengl::impl {
-      struct texture_handle {
-        texture_handle() { glGenTextures(1, &this->texture); }
-        ~texture_handle() {
-          if (this->texture)
-            glDeleteTextures(1, &this->texture);
-        }
+      /** a vertex of the text quads, drawn with the glyph atlas texture */
+      struct text_vertex {
+        text_vertex(glm::vec2 const& position, glm::vec2 const& texture, glm::vec4 const& color) : position(position), texture(texture), color(color) {}
 
-        GLuint     texture;
-        glm::ivec2 dimensions;
-        float      super_sampling_factor;
-        bool       used;
+        glm::vec2 position;
+        glm::vec2 texture;
+        glm::vec4 color;
       };
 
       /**
-       * Render some text to an OpenGL texture, and cache it, using the text data, font and anchor as the key.
-       *
-       * If the cache already contains the key, no need to render it again, just return the texture.
+       * A text laid out from the origin, with the generation of the atlas its quads refer to, and whether its glyphs were
+       * all rasterized already.
        */
-      texture_handle const& make_texture(std::string const& text, text::anchor const& anchor, std::string const& font) {
-        std::string const& key = text + " - " + font + " - " + boost::lexical_cast< std::string >(static_cast< size_t >(anchor));
-
-        {
-          auto const& it = this->texture_cache.find(key);
-          if (it != this->texture_cache.end()) {
-            it->second.used = true;
-            return it->second;
-          }
+      struct laid_out_text {
+        glm::vec2                                  dimensions;
+        std::vector< renderer::glyph_atlas::quad > quads;
+        uint64_t                                   generation;
+        bool                                       complete;
+      };
+
+      impl() :
+        atlas(glm::ivec2(1024, 1024), config::get("display.async-text", true)),
+        atlas_texture(0),
+        text_cache(static_cast< size_t >(config::get("display.text-cache-mb", 32)) << 20),
+        stream_buffer(0),
+        tolerance(config::get("display.curve-tolerance", 0.25)),
+        tolerance_scale(1.0f),
+        vertex_budget(static_cast< size_t >(config::get("display.curve-vertex-budget", 262144))),
+        frame_line_vertices(0),
+        frame_submitted(false),
+        readback_depth(static_cast< size_t >(config::get("output.readback-frames", 3)))
+      {}
+
+      /** the current tessellation tolerance, raised while the frames go over the vertex budget */
+      float curve_tolerance() const {
+        return this->tolerance * this->tolerance_scale;
+      }
+
+      ~impl() {
+        if (this->atlas_texture)
+          glDeleteTextures(1, &this->atlas_texture);
+
+        this->release_buffers();
+      }
+
+      /** deletes the vertex and pixel buffers, dropping the frames still being read back */
+      void release_buffers() {
+        gl_extensions const& gl = gl_extensions::get();
+
+        if (this->stream_buffer)
+          gl.delete_buffers(1, &this->stream_buffer);
+        this->stream_buffer = 0;
+
+        for (auto const& readback : this->readbacks) {
+          gl.delete_sync(readback.fence);
+          this->readback_buffers.push_back(readback.buffer);
         }
+        this->readbacks.clear();
 
-        texture_handle& handle = this->texture_cache.insert(std::make_pair(key, texture_handle())).first->second;
+        if (!this->readback_buffers.empty())
+          gl.delete_buffers(static_cast< GLsizei >(this->readback_buffers.size()), this->readback_buffers.data());
+        this->readback_buffers.clear();
+      }
 
-        handle.super_sampling_factor = 1.0;
+      /**
+       * Streams the vertices to the vertex buffer, orphaning its previous content so that the driver does not wait for the
+       * previous draw calls to complete.
+       * @return the base address to give to the vertex array pointers, or the vertices themselves without buffer objects
+       */
+      template< typename Vertex >
+      char const* stream(std::vector< Vertex > const& vertices) {
+        gl_extensions const& gl = gl_extensions::get();
+        if (!gl.has_buffers())
+          return reinterpret_cast< char const* >(vertices.data());
 
-        static PangoFontMap* const pango_fontmap = pango_cairo_font_map_get_default();
-        PangoContext* const        pango_context = pango_font_map_create_context(pango_fontmap);
+        GLsizeiptr const size = static_cast< GLsizeiptr >(vertices.size() * sizeof(Vertex));
 
-        cairo_font_options_t* const font_options = cairo_font_options_create();
-        cairo_font_options_set_antialias(font_options, CAIRO_ANTIALIAS_SUBPIXEL);
-        cairo_font_options_set_hint_style(font_options, CAIRO_HINT_STYLE_FULL);
-        cairo_font_options_set_hint_metrics(font_options, CAIRO_HINT_METRICS_ON);
+        if (!this->stream_buffer)
+          gl.gen_buffers(1, &this->stream_buffer);
 
-        pango_cairo_context_set_font_options(pango_context, font_options);
-        cairo_font_options_destroy(font_options);
+        gl.bind_buffer(GL_ARRAY_BUFFER, this->stream_buffer);
+        gl.buffer_data(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+        gl.buffer_sub_data(GL_ARRAY_BUFFER, 0, size, vertices.data());
 
-        PangoFontDescription* const pango_font = pango_font_description_from_string(font.c_str());
+        return NULL;
+      }
 
-        float const scaling_factor = std::max(1.0f, pango_font_description_get_size(pango_font) / static_cast< float >(40 * PANGO_SCALE));
-        if (scaling_factor > 1.0)
-          pango_font_description_set_size(pango_font, 40 * PANGO_SCALE);
+      /** unbinds the vertex buffer, if any, after drawing the streamed vertices */
+      void unbind() {
+        gl_extensions const& gl = gl_extensions::get();
+        if (gl.has_buffers())
+          gl.bind_buffer(GL_ARRAY_BUFFER, 0);
+      }
 
-#ifdef _WIN32
-        if (scaling_factor > 1.0)
-          handle.super_sampling_factor = 3.0;
-#endif // ifdef _WIN32
+      /**
+       * Coarsens the curves of the next frames when the submitted frame was over the vertex budget, and refines them back
+       * when it was well below it. The tolerance only changes between frames, so the cached curves are kept within one.
+       */
+      void adjust_tolerance() {
+        if ((this->frame_line_vertices > this->vertex_budget) && (this->tolerance_scale < 64.0f))
+          this->tolerance_scale *= 2.0f;
+        else if ((this->frame_line_vertices < this->vertex_budget / 4) && (this->tolerance_scale > 1.0f))
+          this->tolerance_scale /= 2.0f;
 
-        pango_context_set_font_description(pango_context, pango_font);
+        this->frame_line_vertices = 0;
+      }
 
-        PangoLayout* const pango_layout = pango_layout_new(pango_context);
-        switch (anchor) {
-          case text::anchor::TOP_LEFT:
-          case text::anchor::CENTER_LEFT:
-          case text::anchor::BOTTOM_LEFT:
-            pango_layout_set_alignment(pango_layout, PANGO_ALIGN_LEFT);
-            break;
+      void draw_lines() {
+        if (this->line_vertices.empty())
+          return;
 
-          case text::anchor::TOP_CENTER:
-          case text::anchor::CENTER_CENTER:
-          case text::anchor::BOTTOM_CENTER:
-            pango_layout_set_alignment(pango_layout, PANGO_ALIGN_CENTER);
-            break;
+        // the line vertices of every layer are counted against the budget of the frame
+        this->frame_line_vertices += this->line_vertices.size();
 
-          case text::anchor::TOP_RIGHT:
-          case text::anchor::CENTER_RIGHT:
-          case text::anchor::BOTTOM_RIGHT:
-            pango_layout_set_alignment(pango_layout, PANGO_ALIGN_RIGHT);
-            break;
-        }
-        pango_layout_set_markup(pango_layout, text.c_str(), -1);
-
-        pango_layout_get_pixel_size(pango_layout, &handle.dimensions.x, &handle.dimensions.y);
-        handle.dimensions = glm::ivec2(glm::vec2(handle.dimensions) * scaling_factor * handle.super_sampling_factor);
-
-        cairo_surface_t* const cairo_surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, handle.dimensions.x, handle.dimensions.y);
-        cairo_t* const         cairo_context = cairo_create(cairo_surface);
-
-        pango_cairo_update_context(cairo_context, pango_context);
-        cairo_set_source_rgb(cairo_context, 0.0, 0.0, 0.0);
-        cairo_paint(cairo_context);
-        cairo_set_antialias(cairo_context, CAIRO_ANTIALIAS_SUBPIXEL);
-        cairo_scale(cairo_context, scaling_factor * handle.super_sampling_factor, scaling_factor * handle.super_sampling_factor);
-
-#ifdef _WIN32
-        cairo_move_to(cairo_context, -0.1, -0.1);
-        cairo_set_source_rgb(cairo_context, 0.5, 0.5, 0.5);
-        pango_cairo_update_layout(cairo_context, pango_layout);
-        pango_cairo_show_layout(cairo_context, pango_layout);
-
-        cairo_move_to(cairo_context, 0.1, -0.1);
-        cairo_set_source_rgb(cairo_context, 0.5, 0.5, 0.5);
-        pango_cairo_update_layout(cairo_context, pango_layout);
-        pango_cairo_show_layout(cairo_context, pango_layout);
-
-        cairo_move_to(cairo_context, -0.1, 0.1);
-        cairo_set_source_rgb(cairo_context, 0.5, 0.5, 0.5);
-        pango_cairo_update_layout(cairo_context, pango_layout);
-        pango_cairo_show_layout(cairo_context, pango_layout);
-
-        cairo_move_to(cairo_context, 0.1, 0.1);
-        cairo_set_source_rgb(cairo_context, 0.5, 0.5, 0.5);
-        pango_cairo_update_layout(cairo_context, pango_layout);
-        pango_cairo_show_layout(cairo_context, pango_layout);
-
-        cairo_move_to(cairo_context, 0.0, 0.0);
-        cairo_set_source_rgb(cairo_context, 1.0, 1.0, 1.0);
-        pango_cairo_update_layout(cairo_context, pango_layout);
-        pango_cairo_show_layout(cairo_context, pango_layout);
-
-        if (scaling_factor > 1.0)
-          cairo_image_surface_blur(cairo_surface, 1.0);
-
-#else // ifdef _WIN32
-        cairo_move_to(cairo_context, 0.0, 0.0);
-        cairo_set_source_rgb(cairo_context, 1.0, 1.0, 1.0);
-
-        pango_cairo_layout_path(cairo_context, pango_layout);
-        cairo_fill(cairo_context);
-
-#endif // ifdef _WIN32
-
-        uint32_t* const color_data = reinterpret_cast< uint32_t* >(cairo_image_surface_get_data(cairo_surface));
-        for (int32_t i = 0; i < handle.dimensions.x * handle.dimensions.y; ++i) {
-          uint8_t* const components = reinterpret_cast< uint8_t* >(color_data + i);
-          components[3] = (components[0] + components[1] + components[2]) / 3;
-        }
+        char const* const base = this->stream(this->line_vertices);
+
+        // the strips carry their own antialiasing fringe, the polygon smoothing would outline every triangle of them
+        glDisable(GL_POLYGON_SMOOTH);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
 
-        glEnable(GL_TEXTURE_RECTANGLE);
-        glBindTexture(GL_TEXTURE_RECTANGLE, handle.texture);
-        glTexImage2D(GL_TEXTURE_RECTANGLE, 0, GL_RGBA8, handle.dimensions.x, handle.dimensions.y, 0, GL_BGRA, GL_UNSIGNED_BYTE, cairo_image_surface_get_data(cairo_surface));
+        glVertexPointer(2, GL_FLOAT, sizeof(line_vertex), base + offsetof(line_vertex, position));
+        glColorPointer(4, GL_FLOAT, sizeof(line_vertex), base + offsetof(line_vertex, color));
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, static_cast< GLsizei >(this->line_vertices.size()));
+
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glEnable(GL_POLYGON_SMOOTH);
+
+        this->unbind();
+        this->line_vertices.clear();
+      }
 
-        cairo_surface_finish(cairo_surface);
-        cairo_surface_write_to_png(cairo_surface, (key + ".png").c_str());
+      void draw_text() {
+        if (this->text_vertices.empty())
+          return;
 
-        cairo_destroy(cairo_context);
-        cairo_surface_destroy(cairo_surface);
+        glEnable(GL_TEXTURE_2D);
+        this->upload_atlas();
 
-        g_object_unref(pango_layout);
-        pango_font_description_free(pango_font);
-        g_object_unref(pango_context);
+        char const* const base = this->stream(this->text_vertices);
 
-        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
 
-        if (!__glGenerateMipmap)
-          __glGenerateMipmap = (PFNGLGENERATEMIPMAPPROC) glfwGetProcAddress("glGenerateMipmap");
-        glHint(GL_GENERATE_MIPMAP_HINT, GL_NICEST);
-        __glGenerateMipmap(GL_TEXTURE_RECTANGLE);
+        glVertexPointer(2, GL_FLOAT, sizeof(text_vertex), base + offsetof(text_vertex, position));
+        glTexCoordPointer(2, GL_FLOAT, sizeof(text_vertex), base + offsetof(text_vertex, texture));
+        glColorPointer(4, GL_FLOAT, sizeof(text_vertex), base + offsetof(text_vertex, color));
+        glDrawArrays(GL_QUADS, 0, static_cast< GLsizei >(this->text_vertices.size()));
 
-        handle.used = true;
-        return handle;
-      } // make_texture
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
 
-      std::unordered_map< std::string, texture_handle > texture_cache;
+        glDisable(GL_TEXTURE_2D);
+
+        this->unbind();
+        this->text_vertices.clear();
+      }
+
+      /**
+       * Lays the text out from the glyph atlas, and caches it. The anchor only moves the text, so the laid out text is
+       * cached once for every anchor.
+       */
+      laid_out_text const& make_text(std::string const& text, std::string const& font) {
+        laid_out_text* const cached = this->text_cache.find(text, text::anchor::TOP_LEFT, font);
+        if (cached && cached->complete && (cached->generation == this->atlas.generation()))
+          return *cached;
+
+        // lay the text out again if the atlas has been cleared since, and while some of its glyphs are still missing
+        laid_out_text laid_out;
+        laid_out.generation = this->atlas.generation();
+        laid_out.dimensions = this->atlas.layout(text, glm::vec2(0.0f, 0.0f), font, laid_out.quads, &laid_out.complete);
+
+        // the stale entry, if any, is replaced by the insertion, so that its size is accounted again
+        size_t const bytes = sizeof(laid_out_text) + laid_out.quads.size() * sizeof(renderer::glyph_atlas::quad);
+        return this->text_cache.insert(text, text::anchor::TOP_LEFT, font, std::move(laid_out), bytes);
+      } // make_text
+
+      /** uploads the glyphs rasterized since the last upload to the atlas texture, creating it if needed */
+      void upload_atlas() {
+        glm::ivec2 const& dimension = this->atlas.dimension();
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        if (!this->atlas_texture) {
+          glGenTextures(1, &this->atlas_texture);
+          glBindTexture(GL_TEXTURE_2D, this->atlas_texture);
+          glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+          glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+          glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, dimension.x, dimension.y, 0, GL_ALPHA, GL_UNSIGNED_BYTE, this->atlas.pixels());
+          this->atlas.clean();
+        }
+
+        glBindTexture(GL_TEXTURE_2D, this->atlas_texture);
+        if (this->atlas.dirty()) {
+          glm::ivec2 const rows = this->atlas.dirty_range();
+          glTexSubImage2D(GL_TEXTURE_2D, 0, 0, rows.x, dimension.x, rows.y - rows.x, GL_ALPHA, GL_UNSIGNED_BYTE, this->atlas.pixels() + rows.x * dimension.x);
+          this->atlas.clean();
+        }
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      }
+
+      renderer::glyph_atlas                 atlas;
+      GLuint                                atlas_texture;
+      renderer::text_cache< laid_out_text > text_cache;
+      std::vector< text_vertex >            text_vertices;
+
+      GLuint                     stream_buffer;
+      std::vector< line_vertex > line_vertices;
+      std::vector< glm::vec3 >   curve_vertices;
+      std::vector< float >       curve_parameters;
+
+      float const  tolerance;
+      float        tolerance_scale;
+      size_t const vertex_budget;
+      size_t       frame_line_vertices;
+      bool         frame_submitted;
+
+      /** a frame read back to a pixel buffer, with the fence signaled once the read is complete */
+      struct readback {
+        GLuint     buffer;
+        GLsync     fence;
+        glm::ivec2 dimension;
+      };
+
+      /** the number of frames read back before waiting for the oldest one, the frames being read back, and the free buffers */
+      size_t const           readback_depth;
+      std::deque< readback > readbacks;
+      std::vector< GLuint >  readback_buffers;
     };
 
     opengl::opengl(glm::ivec2 const& source_dimension) :
@@ -329,26 +421,26 @@ namespace logoprism {
       glEnable(GL_POLYGON_SMOOTH);
     }
 
-    void opengl::cleanup_cache() {
-      if (this->impl_ptr->texture_cache.size() < 50)
-        return;
-
-      std::vector< std::string > unused;
+    void opengl::cleanup_cache() {}
 
-      for (auto& pair : this->impl_ptr->texture_cache) {
-        if (pair.second.used)
-          pair.second.used = false;
-        else
-          unused.push_back(pair.first);
+    void opengl::clear_cache() {
+      // the window, and thus the GL context, may have been created again, the atlas is rasterized and uploaded again
+      this->impl_ptr->atlas.clear();
+      this->impl_ptr->text_cache.clear();
+      this->impl_ptr->text_vertices.clear();
+      if (this->impl_ptr->atlas_texture) {
+        glDeleteTextures(1, &this->impl_ptr->atlas_texture);
+        this->impl_ptr->atlas_texture = 0;
       }
 
-      for (auto const& key : unused) {
-        this->impl_ptr->texture_cache.erase(key);
-      }
+      // the frames being read back are lost with the previous context, the video goes on from the next one
+      if (!this->impl_ptr->readbacks.empty())
+        std::clog << "W: dropping " << this->impl_ptr->readbacks.size() << " frames being read back" << std::endl;
+      this->impl_ptr->release_buffers();
     }
 
-    void opengl::clear_cache() {
-      this->impl_ptr->texture_cache.clear();
+    renderer::cache_statistics opengl::text_cache_statistics() const {
+      return this->impl_ptr->text_cache.stats();
     }
 
     void opengl::erase() {
@@ -356,96 +448,160 @@ namespace logoprism {
       glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
-    glm::vec2 opengl::measure(std::string const& text, text::anchor const& anchor, std::string const& font) {
-      auto const& handle = this->impl_ptr->make_texture(text, anchor, font);
+    glm::vec2 opengl::measure(std::string const& text, text::anchor const&, std::string const& font) {
+      return this->impl_ptr->make_text(text, font).dimensions;
+    }
+
+    void opengl::submit(renderer::command_buffer const& commands) {
+      // the curves and the text of a layer are batched, and drawn before the commands of the next layer
+      this->impl_ptr->frame_submitted = true;
+      uint64_t layer = commands.begin()->key >> 32;
+      for (auto const& command : commands) {
+        if ((command.key >> 32) != layer) {
+          this->impl_ptr->draw_lines();
+          this->impl_ptr->draw_text();
+          layer = command.key >> 32;
+        }
 
-      return glm::vec2(handle.dimensions) / handle.super_sampling_factor;
+        this->draw(commands, command);
+      }
     }
 
-    void opengl::render(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color) {
-      auto const& handle = this->impl_ptr->make_texture(text, anchor, font);
+    void opengl::draw_text(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color) {
+      auto const&     laid_out = this->impl_ptr->make_text(text, font);
+      glm::vec2 const top_left = glm::vec2(glm::ivec2(position + alignment_ratio(anchor) * laid_out.dimensions));
 
-      glm::vec2 const&  dimensions   = glm::vec2(handle.dimensions);
-      glm::ivec2 const& top_left     = glm::ivec2(position + alignment_ratio(anchor) * dimensions);
-      glm::ivec2 const& bottom_right = top_left + glm::ivec2(dimensions);
+      // the glyphs are queued, and drawn at once when the frame is flushed
+      auto& vertices = this->impl_ptr->text_vertices;
+      for (auto const& q : laid_out.quads) {
+        glm::vec2 const q_top_left     = top_left + q.top_left;
+        glm::vec2 const q_bottom_right = top_left + q.bottom_right;
 
-      glColor4fv(glm::value_ptr(color));
-      glEnable(GL_TEXTURE_RECTANGLE);
-      glBindTexture(GL_TEXTURE_RECTANGLE, handle.texture);
+        vertices.emplace_back(q_top_left, q.texture_top_left, color);
+        vertices.emplace_back(glm::vec2(q_top_left.x, q_bottom_right.y), glm::vec2(q.texture_top_left.x, q.texture_bottom_right.y), color);
+        vertices.emplace_back(q_bottom_right, q.texture_bottom_right, color);
+        vertices.emplace_back(glm::vec2(q_bottom_right.x, q_top_left.y), glm::vec2(q.texture_bottom_right.x, q.texture_top_left.y), color);
+      }
+    }
 
-      glBegin(GL_QUADS);
-      glTexCoord2iv(glm::value_ptr(glm::ivec2(0, 0)));
-      glVertex2iv(glm::value_ptr(top_left));
+    void opengl::commit() {
+      // the curves and the text of the last layer are drawn at once, the text over the curves
+      this->impl_ptr->draw_lines();
+      this->impl_ptr->draw_text();
 
-      glTexCoord2iv(glm::value_ptr(glm::ivec2(0, handle.dimensions.y)));
-      glVertex2iv(glm::value_ptr(glm::ivec2(top_left.x, bottom_right.y)));
+      // the tolerance is only adjusted for the frames with commands, not for the empty flushes before reading back
+      if (this->impl_ptr->frame_submitted) {
+        this->impl_ptr->adjust_tolerance();
+        this->impl_ptr->frame_submitted = false;
+      }
 
-      glTexCoord2iv(glm::value_ptr(handle.dimensions));
-      glVertex2iv(glm::value_ptr(bottom_right));
+      // the glyphs rasterized in the background are added once the frame text is drawn, and the atlas is only cleared when
+      // full once no queued quad refers to it anymore, its missing glyphs being rasterized again for the next frame
+      this->impl_ptr->atlas.update();
+      if (this->impl_ptr->atlas.full())
+        this->impl_ptr->atlas.clear();
+    }
 
-      glTexCoord2iv(glm::value_ptr(glm::ivec2(handle.dimensions.x, 0)));
-      glVertex2iv(glm::value_ptr(glm::ivec2(bottom_right.x, top_left.y)));
-      glEnd();
+    void opengl::draw_curve(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width) {
+      auto& vertices = this->impl_ptr->curve_vertices;
 
-      glDisable(GL_TEXTURE_RECTANGLE);
+      vertices.clear();
+      tessellate(points, range, fading, this->impl_ptr->curve_tolerance(), this->impl_ptr->curve_parameters, vertices);
+      append_strip(vertices, color, width, this->impl_ptr->line_vertices);
     }
 
-    void opengl::render(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width) {
-      double curve_start   = range.x;
-      double curve_end     = range.y;
-      size_t segment_count = static_cast< uint64_t >((curve_end - curve_start) * 50) + 1;
-      double curve_step    = (curve_end - curve_start) / static_cast< double >(segment_count);
-
-      auto const get_fading_alpha = [&](double const position) -> double {
-                                      if (fading.x <= fading.y)
-                                        return glm::clamp((position - fading.x) / (fading.y - fading.x), 0.0, 1.0);
-                                      else
-                                        return -glm::clamp((position - fading.x) / (fading.x - fading.y), -1.0, 0.0);
-                                    };
-
-      std::vector< glm::vec2 > points_vector;
-
-      points_vector.emplace_back(std::get< 0 >(points));
-      points_vector.emplace_back(std::get< 1 >(points));
-      points_vector.emplace_back(std::get< 2 >(points));
-      points_vector.emplace_back(std::get< 3 >(points));
-
-      glm::vec2 prev;
-      glm::vec2 next = bezier_impl< >::compute(curve_start, points_vector);
-
-      std::vector< std::pair< glm::vec3, glm::vec3 > > segments;
-      for (double curve_position = curve_start + curve_step; curve_position < curve_end; curve_position += curve_step) {
-        prev = next;
-        next = bezier_impl< >::compute(curve_position, points_vector);
-        segments.push_back(std::make_pair(glm::vec3(prev.x, prev.y, get_fading_alpha(curve_position)),
-                                          glm::vec3(next.x, next.y, get_fading_alpha(curve_position + curve_step))));
+    void opengl::draw_curve(renderer::curve const& curve, glm::vec4 const& color, double const width) {
+      // only tessellate the curve again if it has changed since the last time, or if the tolerance has
+      float const tolerance = this->impl_ptr->curve_tolerance();
+      if ((curve.tessellated_revision != curve.revision) || (curve.tessellated_tolerance != tolerance)) {
+        curve.vertices.clear();
+        tessellate(curve.control_points, curve.range, curve.fading, tolerance, this->impl_ptr->curve_parameters, curve.vertices);
+        curve.tessellated_revision  = curve.revision;
+        curve.tessellated_tolerance = tolerance;
       }
 
-      prev = next;
-      next = bezier_impl< >::compute(curve_end, points_vector);
-      segments.push_back(std::make_pair(glm::vec3(prev.x, prev.y, get_fading_alpha(curve_end)),
-                                        glm::vec3(next.x, next.y, get_fading_alpha(curve_end))));
-
-      glColor4fv(glm::value_ptr(color));
-      glLineWidth(width);
-      glBegin(GL_LINES);
-      for (auto& pair : segments) {
-        glColor4fv(glm::value_ptr(glm::vec4(color.x, color.y, color.z, color.w * pair.first.z)));
-        glVertex2fv(glm::value_ptr(pair.first));
-        glColor4fv(glm::value_ptr(glm::vec4(color.x, color.y, color.z, color.w * pair.second.z)));
-        glVertex2fv(glm::value_ptr(pair.second));
-      }
-      glEnd();
+      append_strip(curve.vertices, color, width, this->impl_ptr->line_vertices);
     }
 
     void opengl::read(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t* const& target) {
+      this->flush();
       glReadPixels(offset.x, offset.y, dimension.x, dimension.y, GL_BGRA, GL_UNSIGNED_BYTE, target);
     }
 
+    void opengl::read_async(glm::ivec2 const& offset, glm::ivec2 const& dimension) {
+      auto&                self = *this->impl_ptr;
+      gl_extensions const& gl   = gl_extensions::get();
+
+      if ((self.readback_depth == 0) || !gl.has_buffers() || !gl.has_sync()) {
+        renderer::base::read_async(offset, dimension);
+        return;
+      }
+
+      this->flush();
+
+      impl::readback readback;
+      readback.dimension = dimension;
+      if (self.readback_buffers.empty()) {
+        gl.gen_buffers(1, &readback.buffer);
+      } else {
+        readback.buffer = self.readback_buffers.back();
+        self.readback_buffers.pop_back();
+      }
+
+      // the pixels are copied to the pixel buffer by the GPU once the frame is drawn, without waiting for it
+      gl.bind_buffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+      gl.buffer_data(GL_PIXEL_PACK_BUFFER, dimension.x * dimension.y * 4, NULL, GL_STREAM_READ);
+      glReadPixels(offset.x, offset.y, dimension.x, dimension.y, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+      gl.bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+
+      readback.fence = gl.fence_sync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+      self.readbacks.push_back(readback);
+    }
+
+    bool opengl::read_ready(bool const wait) {
+      auto& self = *this->impl_ptr;
+
+      if (self.readbacks.empty())
+        return renderer::base::read_ready(wait);
+
+      // a frame is only retrieved once readback_depth frames are being read back, so that every frame comes exactly
+      // readback_depth - 1 frames late, the GPU having had that long to copy it
+      return wait || (self.readbacks.size() >= self.readback_depth);
+    }
+
+    void opengl::read_pending(uint8_t* const& target) {
+      auto&                self = *this->impl_ptr;
+      gl_extensions const& gl   = gl_extensions::get();
+
+      if (self.readbacks.empty()) {
+        renderer::base::read_pending(target);
+        return;
+      }
+
+      // the copy of the oldest frame has usually completed by now, otherwise it is waited for
+      impl::readback const readback = self.readbacks.front();
+
+      GLenum status = gl.client_wait_sync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+      while (status == GL_TIMEOUT_EXPIRED)
+        status = gl.client_wait_sync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+
+      gl.delete_sync(readback.fence);
+      self.readbacks.pop_front();
+      self.readback_buffers.push_back(readback.buffer);
+
+      gl.bind_buffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+      void const* const pixels = gl.map_buffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+      if (pixels) {
+        std::memcpy(target, pixels, readback.dimension.x * readback.dimension.y * 4);
+        gl.unmap_buffer(GL_PIXEL_PACK_BUFFER);
+      } else {
+        std::clog << "E: unable to map the pixel buffer of a frame read back" << std::endl;
+      }
+      gl.bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+    } // read_pending
+
     void opengl::write(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t const* const& source) {
-      if (!__glWindowPos2iv)
-        __glWindowPos2iv = (PFNGLWINDOWPOS2IVPROC) glfwGetProcAddress("glWindowPos2iv");
-      __glWindowPos2iv(glm::value_ptr(offset));
+      gl_extensions::get().window_pos_2iv(glm::value_ptr(offset));
       glDrawPixels(dimension.x, dimension.y, GL_BGRA, GL_UNSIGNED_BYTE, source);
     }
 
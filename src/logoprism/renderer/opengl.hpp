@@ -14,17 +14,30 @@ namespace logoprism {
       void cleanup_cache();
       void clear_cache();
 
+      renderer::cache_statistics text_cache_statistics() const;
+
       void erase();
 
       glm::vec2 measure(std::string const& text, text::anchor const& anchor, std::string const& font);
-      void      render(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color);
-
-      void render(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width);
 
       void read(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t* const& target);
 
       void write(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t const* const& source);
 
+      void read_async(glm::ivec2 const& offset, glm::ivec2 const& dimension);
+      bool read_ready(bool const wait);
+      void read_pending(uint8_t* const& target);
+
+      protected:
+        void submit(renderer::command_buffer const& commands);
+
+        void draw_text(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color);
+
+        void draw_curve(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width);
+        void draw_curve(renderer::curve const& curve, glm::vec4 const& color, double const width);
+
+        void commit();
+
       private:
         struct impl;
 
@@ -1,10 +1,85 @@
 #include "logoprism/renderer/renderer.hpp"
+#include "logoprism/renderer/command_buffer.hpp"
 
 namespace logoprism {
   namespace renderer {
 
-    base::base(glm::ivec2 const& source_dimension) : source_dimension(source_dimension) {}
+    base::base(glm::ivec2 const& source_dimension) :
+      source_dimension(source_dimension),
+      frame(new renderer::command_buffer())
+    {}
+
     base::~base() {}
 
+    void base::render(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color) {
+      this->frame->record(text, position, anchor, font, color);
+    }
+
+    void base::render(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width) {
+      this->frame->record(points, range, fading, color, width);
+    }
+
+    void base::render(renderer::curve const& curve, glm::vec4 const& color, double const width) {
+      this->frame->record(curve, color, width);
+    }
+
+    void base::layer(uint16_t const layer) {
+      this->frame->layer(layer);
+    }
+
+    void base::flush() {
+      if (!this->frame->empty()) {
+        this->frame->sort();
+        this->submit(*this->frame);
+      }
+      this->frame->clear();
+
+      this->commit();
+    }
+
+    void base::read_async(glm::ivec2 const& offset, glm::ivec2 const& dimension) {
+      this->reads.push_back(std::make_pair(offset, dimension));
+    }
+
+    bool base::read_ready(bool const) {
+      return !this->reads.empty();
+    }
+
+    void base::read_pending(uint8_t* const& target) {
+      this->read(this->reads.front().first, this->reads.front().second, target);
+      this->reads.pop_front();
+    }
+
+    void base::submit(renderer::command_buffer const& commands) {
+      for (auto const& command : commands) {
+        this->draw(commands, command);
+      }
+    }
+
+    void base::draw(renderer::command_buffer const& commands, renderer::command const& command) {
+      switch (command.kind) {
+        case renderer::command::type::TEXT:
+          this->draw_text(commands.text(command), command.position, command.anchor, commands.font(command), command.color);
+          break;
+
+        case renderer::command::type::CURVE:
+          if (command.curve)
+            this->draw_curve(*command.curve, command.color, command.width);
+          else
+            this->draw_curve(command.points, command.range, command.fading, command.color, command.width);
+          break;
+      }
+    }
+
+    void base::draw_curve(renderer::curve const& curve, glm::vec4 const& color, double const width) {
+      this->draw_curve(curve.control_points, curve.range, curve.fading, color, width);
+    }
+
+    void base::commit() {}
+
+    renderer::cache_statistics base::text_cache_statistics() const {
+      return renderer::cache_statistics();
+    }
+
   }
 }
@@ -3,6 +3,11 @@
 
 #include "logoprism/data/types.hpp"
 
+#include <deque>
+#include <memory>
+#include <tuple>
+#include <utility>
+
 namespace logoprism {
 
   namespace text {
@@ -54,6 +59,76 @@ namespace logoprism {
 
   namespace renderer {
 
+    /**
+     * Horizontal cubic bezier curve between two anchors, with the visible range and the fading along the curve.
+     *
+     * The control points are only computed again when the anchors, range or fading change, and the renderers may keep
+     * the tessellated curve until then, comparing the curve revision and their tolerance with the ones they have
+     * tessellated it with.
+     */
+    struct curve {
+      typedef std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > control_points_type;
+
+      curve() :
+        control_points(),
+        range(),
+        fading(),
+        revision(0),
+        tessellated_revision(-1),
+        tessellated_tolerance(0.0f)
+      {}
+
+      /**
+       * Updates the curve between the given anchors.
+       * @return whether anything has changed
+       */
+      bool update(glm::vec2 const& from, glm::vec2 const& to, glm::vec2 const& range, glm::vec2 const& fading) {
+        if ((this->revision > 0) && (from == std::get< 0 >(this->control_points)) && (to == std::get< 3 >(this->control_points))
+            && (range == this->range) && (fading == this->fading))
+          return false;
+
+        glm::vec2 const middle_point   = (from + to) / 2.0f;
+        glm::vec2 const control_point0 = from + glm::vec2(middle_point.x - from.x, 0.0);
+        glm::vec2 const control_point1 = to + glm::vec2(middle_point.x - to.x, 0.0);
+
+        this->control_points = control_points_type(from, control_point0, control_point1, to);
+        this->range          = range;
+        this->fading         = fading;
+        this->revision      += 1;
+
+        return true;
+      }
+
+      control_points_type control_points;
+      glm::vec2           range;
+      glm::vec2           fading;
+      size_t              revision;
+
+      /** the tessellated curve, cached by the renderer, as pairs of (x, y, fading) line vertices */
+      mutable std::vector< glm::vec3 > vertices;
+      mutable size_t                   tessellated_revision;
+      mutable float                    tessellated_tolerance;
+    };
+
+    /** usage counters of a renderer text cache */
+    struct cache_statistics {
+      cache_statistics() : hits(0), misses(0), evictions(0), entries(0), bytes(0) {}
+
+      uint64_t hits;
+      uint64_t misses;
+      uint64_t evictions;
+      size_t   entries;
+      size_t   bytes;
+    };
+
+    struct command;
+    struct command_buffer;
+
+    /**
+     * Renderer interface used by the views. The views measure their text right away, but their text and curves are only
+     * recorded in a frame command buffer, sorted and handed to the renderer implementation as a whole when flushed, so
+     * that the implementations may batch, cull or parallelize the drawing of a frame.
+     */
     struct base {
       base(glm::ivec2 const& source_dimension);
       virtual ~base();
@@ -64,17 +139,29 @@ namespace logoprism {
       /** clears the text cache, removing any cached text data from it */
       virtual void clear_cache() = 0;
 
+      /** the usage counters of the text cache, if there's any */
+      virtual renderer::cache_statistics text_cache_statistics() const;
+
       /** clears the screen */
       virtual void erase() = 0;
 
       /** @brief measures the number of pixels the text would take if rendered with given anchor and font. */
       virtual glm::vec2 measure(std::string const& text, text::anchor const& anchor, std::string const& font) = 0;
 
-      /** @brief renders text at position, with given anchor, font, and color and adjusting the rendered area using overflow's dimension/ratio. */
-      virtual void render(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color) = 0;
+      /** @brief records the text at position, with given anchor, font, and color, to be drawn when the frame is flushed. */
+      void render(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color);
+
+      /** @brief records the lines, with given color and width, to be drawn when the frame is flushed. */
+      void render(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width);
 
-      /** @brief renders the lines, with given color and width. */
-      virtual void render(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width) = 0;
+      /** @brief records the curve, with given color and width, which must not be destroyed before the frame is flushed. */
+      void render(renderer::curve const& curve, glm::vec4 const& color, double const width);
+
+      /** @brief sets the layer of the commands recorded from now on, the higher layers are drawn over the lower ones. */
+      void layer(uint16_t const layer);
+
+      /** @brief draws the commands recorded during the frame, before the frame is displayed or read. */
+      void flush();
 
       /** @brief copies 24bit RGB pixel data to target. */
       virtual void read(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t* const& target) = 0;
@@ -82,7 +169,50 @@ namespace logoprism {
       /** @brief copies 24bit RGB pixel data from source. */
       virtual void write(glm::ivec2 const& offset, glm::ivec2 const& dimension, uint8_t const* const& source) = 0;
 
+      /**
+       * @brief starts copying the pixel data of the current frame, to be retrieved in order with read_pending.
+       *
+       * By default, the pixel data is only copied when retrieved, so the frame must be retrieved before the next frame is
+       * drawn, which read_ready always allows.
+       */
+      virtual void read_async(glm::ivec2 const& offset, glm::ivec2 const& dimension);
+
+      /**
+       * @brief whether the oldest frame started with read_async is to be retrieved now.
+       * @param  wait whether to retrieve it anyway, waiting for its pixel data if needed
+       * @return      whether read_pending will copy a frame, false if there is none pending or if it is not due yet
+       */
+      virtual bool read_ready(bool const wait);
+
+      /** @brief copies the pixel data of the oldest frame started with read_async to target, once read_ready has allowed it. */
+      virtual void read_pending(uint8_t* const& target);
+
       glm::ivec2 const source_dimension;
+
+      protected:
+        /** draws the commands of a frame, sorted, by default one at a time in order */
+        virtual void submit(renderer::command_buffer const& commands);
+
+        /** draws a single command of the frame */
+        void draw(renderer::command_buffer const& commands, renderer::command const& command);
+
+        /** draws a text, with given anchor, font, and color */
+        virtual void draw_text(std::string const& text, glm::vec2 const& position, text::anchor const& anchor, std::string const& font, glm::vec4 const& color) = 0;
+
+        /** draws the lines, with given color and width */
+        virtual void draw_curve(std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > const& points, glm::vec2 const& range, glm::vec2 const& fading, glm::vec4 const& color, double const width) = 0;
+
+        /** draws the curve, with given color and width, reusing its cached tessellation if the renderer has any */
+        virtual void draw_curve(renderer::curve const& curve, glm::vec4 const& color, double const width);
+
+        /** draws what the renderer may have queued while the frame was submitted */
+        virtual void commit();
+
+      private:
+        std::unique_ptr< renderer::command_buffer > frame;
+
+        /** the offset and dimension of the frames started with read_async, and not retrieved yet */
+        std::deque< std::pair< glm::ivec2, glm::ivec2 > > reads;
     };
 
   }
@@ -0,0 +1,155 @@
+#ifndef __LOGOPRISM_RENDERER_TEXT_CACHE_HPP__
+#define __LOGOPRISM_RENDERER_TEXT_CACHE_HPP__
+
+#include "logoprism/renderer/renderer.hpp"
+
+#include <list>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace logoprism {
+  namespace renderer {
+
+    /**
+     * Least recently used cache of rendered text data, bounded by a memory budget.
+     *
+     * The entries are keyed by the hash of the text, the interned font and the anchor, so that looking a text up does not
+     * build any key string. The text is kept in the entry to tell hash collisions apart. The last entry found is
+     * remembered, as the views usually measure a text and then render it right away.
+     */
+    template< typename T >
+    struct text_cache {
+      public:
+        /**
+         * Creates a new empty text cache.
+         * @param budget the memory budget of the cache, in bytes
+         */
+        text_cache(size_t const budget) :
+          budget(budget),
+          last(this->entries.end())
+        {}
+
+        /** finds the cached data of the text, or returns nullptr and counts a miss */
+        T* find(std::string const& text, text::anchor const& anchor, std::string const& font) {
+          uint32_t const font_id = this->intern(font);
+
+          // the same text is usually looked up twice in a row, no need to hash it again
+          if ((this->last != this->entries.end()) && (this->last->key.font == font_id) && (this->last->key.anchor == anchor) && (this->last->text == text)) {
+            this->statistics.hits += 1;
+            return &this->last->value;
+          }
+
+          key_type const key = { std::hash< std::string >()(text), font_id, anchor };
+          auto const     it  = this->index.find(key);
+          if ((it == this->index.end()) || (it->second->text != text)) {
+            this->statistics.misses += 1;
+            return nullptr;
+          }
+
+          this->statistics.hits += 1;
+
+          this->entries.splice(this->entries.begin(), this->entries, it->second);
+          this->last = this->entries.begin();
+
+          return &this->last->value;
+        }
+
+        /**
+         * Inserts the data of a text, evicting the least recently used entries beyond the budget.
+         * @param bytes the memory used by the data, as estimated by the caller
+         */
+        T& insert(std::string const& text, text::anchor const& anchor, std::string const& font, T&& value, size_t const bytes) {
+          key_type const key = { std::hash< std::string >()(text), this->intern(font), anchor };
+
+          // an entry with the same key, colliding or stale, is replaced and its size released
+          auto const it = this->index.find(key);
+          if (it != this->index.end())
+            this->erase(it->second);
+
+          this->entries.emplace_front(key, text, std::move(value), bytes + text.size() + sizeof(entry));
+          this->index.insert(std::make_pair(key, this->entries.begin()));
+          this->statistics.bytes += this->entries.front().bytes;
+
+          while ((this->statistics.bytes > this->budget) && (this->entries.size() > 1)) {
+            this->erase(std::prev(this->entries.end()));
+            this->statistics.evictions += 1;
+          }
+
+          this->last = this->entries.begin();
+          return this->last->value;
+        }
+
+        /** discards every entry */
+        void clear() {
+          this->index.clear();
+          this->entries.clear();
+          this->last             = this->entries.end();
+          this->statistics.bytes = 0;
+        }
+
+        /** the hit, miss and eviction counters, and the current cache usage */
+        cache_statistics stats() const {
+          cache_statistics statistics = this->statistics;
+          statistics.entries = this->entries.size();
+          return statistics;
+        }
+
+      protected:
+        struct key_type {
+          bool operator==(key_type const& other) const { return this->hash == other.hash && this->font == other.font && this->anchor == other.anchor; }
+
+          size_t       hash;
+          uint32_t     font;
+          text::anchor anchor;
+        };
+
+        struct key_hash {
+          size_t operator()(key_type const& key) const {
+            return key.hash ^ ((static_cast< size_t >(key.font) << 4) | static_cast< size_t >(key.anchor));
+          }
+        };
+
+        struct entry {
+          entry(key_type const& key, std::string const& text, T&& value, size_t const bytes) : key(key), text(text), value(std::move(value)), bytes(bytes) {}
+
+          key_type    key;
+          std::string text;
+          T           value;
+          size_t      bytes;
+        };
+
+        typedef std::list< entry > entries_t;
+
+        size_t const                                                           budget;
+        entries_t                                                              entries;
+        std::unordered_map< key_type, typename entries_t::iterator, key_hash > index;
+        typename entries_t::iterator                                           last;
+        std::vector< std::string >                                             fonts;
+        cache_statistics                                                       statistics;
+
+        /** the identifier of a font, there are only a few of them so they are compared one by one */
+        uint32_t intern(std::string const& font) {
+          for (size_t i = 0; i < this->fonts.size(); ++i) {
+            if (this->fonts[i] == font)
+              return static_cast< uint32_t >(i);
+          }
+
+          this->fonts.push_back(font);
+          return static_cast< uint32_t >(this->fonts.size() - 1);
+        }
+
+        void erase(typename entries_t::iterator const it) {
+          if (it == this->last)
+            this->last = this->entries.end();
+
+          this->statistics.bytes -= it->bytes;
+          this->index.erase(it->key);
+          this->entries.erase(it);
+        }
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_RENDERER_TEXT_CACHE_HPP__
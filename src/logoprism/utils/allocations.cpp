@@ -0,0 +1,61 @@
+#include "logoprism/utils/allocations.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace logoprism {
+  namespace utils {
+
+    namespace allocations {
+
+      static std::atomic< uint64_t > allocation_count(0);
+
+#ifdef LOGOPRISM_ENABLE_ALLOCATION_COUNTER
+      static void* allocate(size_t const size) {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+        void* const pointer = std::malloc(size > 0 ? size : 1);
+        if (pointer == NULL)
+          throw std::bad_alloc();
+
+        return pointer;
+      }
+#endif // ifdef LOGOPRISM_ENABLE_ALLOCATION_COUNTER
+
+      bool enabled() {
+#ifdef LOGOPRISM_ENABLE_ALLOCATION_COUNTER
+        return true;
+#else // ifdef LOGOPRISM_ENABLE_ALLOCATION_COUNTER
+        return false;
+#endif // ifdef LOGOPRISM_ENABLE_ALLOCATION_COUNTER
+      }
+
+      uint64_t count() {
+        return allocation_count.load(std::memory_order_relaxed);
+      }
+
+    }
+
+  }
+}
+
+#ifdef LOGOPRISM_ENABLE_ALLOCATION_COUNTER
+
+void* operator new(size_t size) {
+  return logoprism::utils::allocations::allocate(size);
+}
+
+void* operator new[](size_t size) {
+  return logoprism::utils::allocations::allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  std::free(pointer);
+}
+
+#endif // ifdef LOGOPRISM_ENABLE_ALLOCATION_COUNTER
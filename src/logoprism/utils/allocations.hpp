@@ -0,0 +1,23 @@
+#ifndef __LOGOPRISM_UTILS_ALLOCATIONS_HPP__
+#define __LOGOPRISM_UTILS_ALLOCATIONS_HPP__
+
+#include <cstdint>
+
+namespace logoprism {
+  namespace utils {
+
+    /**
+     * Heap allocation counter, only counting when built with LOGOPRISM_ENABLE_ALLOCATION_COUNTER, as it replaces the
+     * global operator new.
+     */
+    namespace allocations {
+
+      bool     enabled();
+      uint64_t count();
+
+    }
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_UTILS_ALLOCATIONS_HPP__
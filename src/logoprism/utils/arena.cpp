@@ -0,0 +1,53 @@
+#include "logoprism/utils/arena.hpp"
+
+#include <algorithm>
+
+namespace logoprism {
+  namespace utils {
+
+    arena::arena(size_t const block_size) :
+      block_size(block_size),
+      blocks(),
+      block_sizes(),
+      block(0),
+      offset(0),
+      allocated(0)
+    {}
+
+    arena& arena::frame() {
+      static arena frame_arena;
+      return frame_arena;
+    }
+
+    void* arena::allocate(size_t const size, size_t const alignment) {
+      // find room in the current block, or move to the next one, allocating it if needed
+      while (true) {
+        if (this->block < this->blocks.size()) {
+          uintptr_t const base    = reinterpret_cast< uintptr_t >(this->blocks[this->block].get());
+          size_t const    aligned = ((base + this->offset + alignment - 1) & ~(alignment - 1)) - base;
+
+          if (aligned + size <= this->block_sizes[this->block]) {
+            this->offset     = aligned + size;
+            this->allocated += size;
+            return reinterpret_cast< void* >(base + aligned);
+          }
+
+          this->block += 1;
+          this->offset = 0;
+          continue;
+        }
+
+        size_t const block_size = std::max(this->block_size, size + alignment);
+        this->blocks.emplace_back(new uint8_t[block_size]);
+        this->block_sizes.push_back(block_size);
+      }
+    }
+
+    void arena::reset() {
+      this->block     = 0;
+      this->offset    = 0;
+      this->allocated = 0;
+    }
+
+  }
+}
@@ -0,0 +1,83 @@
+#ifndef __LOGOPRISM_UTILS_ARENA_HPP__
+#define __LOGOPRISM_UTILS_ARENA_HPP__
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace logoprism {
+  namespace utils {
+
+    /**
+     * Monotonic memory arena, handing out memory from large blocks and releasing all of it at once. The blocks are kept
+     * when the arena is reset, so that once it has grown to its steady state size, allocating from it does not call the
+     * heap anymore.
+     */
+    struct arena {
+      public:
+        /**
+         * Creates a new empty arena.
+         * @param block_size the size of the memory blocks to allocate from the heap
+         */
+        arena(size_t const block_size=1 << 20);
+
+        arena(arena const&) = delete;
+        arena& operator=(arena const&) = delete;
+
+        /** allocates memory from the arena, it is only released when the arena is reset */
+        void* allocate(size_t const size, size_t const alignment=alignof(std::max_align_t));
+
+        /** releases all the memory allocated from the arena at once, keeping the blocks for later allocations */
+        void reset();
+
+        /** the number of bytes allocated since the last reset */
+        size_t allocated_bytes() const { return this->allocated; }
+
+        /** the arena for the transient data of the current frame, reset at the end of every tick */
+        static arena& frame();
+
+      protected:
+        size_t const block_size;
+
+        std::vector< std::unique_ptr< uint8_t[] > > blocks;
+        std::vector< size_t >                       block_sizes;
+        size_t                                      block;
+        size_t                                      offset;
+        size_t                                      allocated;
+    };
+
+    /**
+     * Standard allocator allocating from an arena, deallocation is a no-op.
+     */
+    template< typename T >
+    struct arena_allocator {
+      typedef T value_type;
+
+      arena_allocator(utils::arena& arena) : arena(&arena) {}
+
+      template< typename U >
+      arena_allocator(arena_allocator< U > const& other) : arena(other.arena) {}
+
+      T* allocate(size_t const count) {
+        return static_cast< T* >(this->arena->allocate(count * sizeof(T), alignof(T)));
+      }
+
+      void deallocate(T*, size_t) {}
+
+      template< typename U >
+      struct rebind { typedef arena_allocator< U > other; };
+
+      template< typename U >
+      bool operator==(arena_allocator< U > const& other) const { return this->arena == other.arena; }
+
+      template< typename U >
+      bool operator!=(arena_allocator< U > const& other) const { return this->arena != other.arena; }
+
+      utils::arena* arena;
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_UTILS_ARENA_HPP__
@@ -0,0 +1,120 @@
+#include "logoprism/utils/thread_pool.hpp"
+
+#include "logoprism/config/config.hpp"
+
+#include <atomic>
+#include <exception>
+#include <iostream>
+
+namespace logoprism {
+  namespace utils {
+
+    thread_pool::thread_pool(size_t thread_count) :
+      thread_count(thread_count > 0 ? thread_count : std::max< size_t >(2, boost::thread::hardware_concurrency()) - 1),
+      stopping(false) {
+      for (size_t i = 0; i < this->thread_count; ++i) {
+        this->threads.create_thread(std::bind(&thread_pool::run, this));
+      }
+    }
+
+    thread_pool::~thread_pool() {
+      {
+        boost::lock_guard< boost::mutex > lock(this->mutex);
+        this->stopping = true;
+      }
+
+      this->task_condition.notify_all();
+      this->threads.join_all();
+    }
+
+    thread_pool& thread_pool::shared() {
+      static thread_pool pool(static_cast< size_t >(config::get("display.threads", 0)));
+      return pool;
+    }
+
+    void thread_pool::post(std::function< void() > const& task) {
+      {
+        boost::lock_guard< boost::mutex > lock(this->mutex);
+        this->tasks.push_back(task);
+      }
+
+      this->task_condition.notify_one();
+    }
+
+    void thread_pool::parallel_for(size_t const count, std::function< void(size_t, size_t) > const& body, size_t const grain) {
+      size_t const chunk_count = std::min(this->thread_count + 1, (count + grain - 1) / std::max< size_t >(1, grain));
+
+      if (chunk_count <= 1) {
+        body(0, count);
+        return;
+      }
+
+      size_t const          chunk_size = (count + chunk_count - 1) / chunk_count;
+      std::atomic< size_t > remaining(chunk_count - 1);
+
+      // the first exception thrown by a chunk, rethrown once every chunk has completed, as they all refer to this frame
+      std::exception_ptr error;
+      boost::mutex       error_mutex;
+      auto const         run_chunk = [&](size_t const begin, size_t const end) {
+                                       try {
+                                         body(begin, end);
+                                       } catch (...) {
+                                         boost::lock_guard< boost::mutex > lock(error_mutex);
+                                         if (!error)
+                                           error = std::current_exception();
+                                       }
+                                     };
+
+      for (size_t chunk = 1; chunk < chunk_count; ++chunk) {
+        size_t const begin = std::min(count, chunk * chunk_size);
+        size_t const end   = std::min(count, begin + chunk_size);
+
+        this->post([&, begin, end]() {
+                     run_chunk(begin, end);
+
+                     if (--remaining == 0) {
+                       boost::lock_guard< boost::mutex > lock(this->mutex);
+                       this->done_condition.notify_all();
+                     }
+                   });
+      }
+
+      // the calling thread takes the first chunk, and waits for the others
+      run_chunk(0, std::min(count, chunk_size));
+
+      {
+        boost::unique_lock< boost::mutex > lock(this->mutex);
+        while (remaining > 0)
+          this->done_condition.wait(lock);
+      }
+
+      if (error)
+        std::rethrow_exception(error);
+    }
+
+    void thread_pool::run() {
+      while (true) {
+        std::function< void() > task;
+
+        {
+          boost::unique_lock< boost::mutex > lock(this->mutex);
+          while (!this->stopping && this->tasks.empty())
+            this->task_condition.wait(lock);
+
+          if (this->stopping && this->tasks.empty())
+            return;
+
+          task = std::move(this->tasks.front());
+          this->tasks.pop_front();
+        }
+
+        try {
+          task();
+        } catch (std::exception const& e) {
+          std::clog << "E: uncaught exception in thread pool task: " << e.what() << std::endl;
+        }
+      }
+    }
+
+  }
+}
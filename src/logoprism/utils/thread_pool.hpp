@@ -0,0 +1,58 @@
+#ifndef __LOGOPRISM_UTILS_THREAD_POOL_HPP__
+#define __LOGOPRISM_UTILS_THREAD_POOL_HPP__
+
+#include <boost/thread.hpp>
+
+#include <deque>
+#include <functional>
+
+namespace logoprism {
+  namespace utils {
+
+    /**
+     * Fixed-size pool of worker threads, running posted tasks in order, and splitting data-parallel loops in chunks.
+     */
+    struct thread_pool {
+      public:
+        /**
+         * Creates a new thread pool.
+         * @param thread_count the number of worker threads, or 0 to use the number of hardware threads minus one, at least one
+         */
+        thread_pool(size_t thread_count);
+        ~thread_pool();
+
+        /** queues a task to be run by one of the worker threads */
+        void post(std::function< void() > const& task);
+
+        /**
+         * Runs a loop body over [0, count), split in contiguous chunks run in parallel by the worker threads and the
+         * calling thread, and waits for all of them to complete. The first exception thrown by a chunk is then rethrown.
+         * @param count the number of iterations
+         * @param body  the loop body, called with the [begin, end) range of a chunk
+         * @param grain the minimum number of iterations per chunk
+         */
+        void parallel_for(size_t const count, std::function< void(size_t, size_t) > const& body, size_t const grain=256);
+
+        /** the number of worker threads */
+        size_t size() const { return this->thread_count; }
+
+        /** the thread pool shared by the application, sized from the display.threads configuration */
+        static thread_pool& shared();
+
+      protected:
+        size_t const thread_count;
+
+        boost::mutex                          mutex;
+        boost::condition_variable             task_condition;
+        boost::condition_variable             done_condition;
+        std::deque< std::function< void() > > tasks;
+        bool                                  stopping;
+        boost::thread_group                   threads;
+
+        void run();
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_UTILS_THREAD_POOL_HPP__
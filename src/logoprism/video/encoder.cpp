@@ -122,6 +122,9 @@ namespace logoprism {
     encoder::~encoder() {
 #ifdef LOGOPRISM_ENABLE_GSTREAMER
 
+      // push the frames still being read before the end of the stream
+      while (this->push_frame(true)) {}
+
       // notify gstreamer that the stream has ended
       gst_app_src_end_of_stream(GST_APP_SRC(this->source));
 
@@ -136,16 +139,31 @@ namespace logoprism {
     void encoder::export_frame() {
 #ifdef LOGOPRISM_ENABLE_GSTREAMER
 
-      // create a gstreamer buffer and copy the current frame to it using the renderer
+      // the frame is read asynchronously by the renderer, and pushed as many frames later as the renderer reads back at once
+      this->renderer.read_async(glm::ivec2(0, 0), this->source_dimension);
+      while (this->push_frame(false)) {}
+
+#endif // ifdef LOGOPRISM_ENABLE_GSTREAMER
+    }
+
+#ifdef LOGOPRISM_ENABLE_GSTREAMER
+
+    bool encoder::push_frame(bool const wait) {
+      // the gstreamer buffer is only allocated once a frame is to be pushed
+      if (!this->renderer.read_ready(wait))
+        return false;
+
+      // create a gstreamer buffer and copy the oldest frame to it using the renderer
       GstBuffer* buffer = gst_buffer_new();
       GstMemory* memory = gst_allocator_alloc(NULL, this->pixel_buffer_size, NULL);
       gst_buffer_insert_memory(buffer, -1, memory);
 
       GstMapInfo map_info;
       gst_buffer_map(buffer, &map_info, GST_MAP_WRITE);
-      this->renderer.read(glm::ivec2(0, 0), this->source_dimension, map_info.data);
+      this->renderer.read_pending(map_info.data);
       gst_buffer_unmap(buffer, &map_info);
 
+      // the frames are pushed in order, so they keep the timestamps they would have had if read synchronously
       GST_BUFFER_DTS(buffer)      = this->frame_timestamp;
       GST_BUFFER_PTS(buffer)      = this->frame_timestamp;
       GST_BUFFER_DURATION(buffer) = this->frame_duration;
@@ -154,8 +172,10 @@ namespace logoprism {
       // push the frame to the appsrc input of the gstreamer pipeline
       gst_app_src_push_buffer(GST_APP_SRC(this->source), buffer);
 
-#endif // ifdef LOGOPRISM_ENABLE_GSTREAMER
+      return true;
     }
 
+#endif // ifdef LOGOPRISM_ENABLE_GSTREAMER
+
   }
 }
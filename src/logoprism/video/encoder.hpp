@@ -19,7 +19,7 @@ namespace logoprism {
         encoder(renderer::base& renderer, std::string const& filename, glm::ivec2 const& source_dimension, size_t const frames_per_second, std::string const& pipeline);
         ~encoder();
 
-        /** reads the current frame from the encoder and pushes it to the video pipeline */
+        /** starts reading the current frame from the renderer, and pushes the frames read so far to the video pipeline */
         void export_frame();
 
 #ifdef LOGOPRISM_ENABLE_GSTREAMER
@@ -42,6 +42,12 @@ namespace logoprism {
         size_t pixel_buffer_size;
 
         boost::thread encoding_thread;
+
+        /**
+         * Pushes the oldest frame started to be read to the video pipeline, if it is due or if wait is set.
+         * @return whether a frame has been pushed
+         */
+        bool push_frame(bool const wait);
 #endif // ifdef LOGOPRISM_ENABLE_GSTREAMER
     };
 
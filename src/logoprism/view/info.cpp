@@ -11,7 +11,8 @@ namespace logoprism {
       view::object(position, dimension),
       message(""),
       timing_message(""),
-      buffering_message("") {
+      buffering_message(""),
+      progress_message("") {
       this->set_speed(1.0);
       this->color = view::color::white;
     }
@@ -36,6 +37,37 @@ namespace logoprism {
       this->buffering_message = stream.str();
     }
 
+    void info::set_progress(data::reading_progress const& progress, data::timings const& timings, double const simulation_rate) {
+      std::stringstream stream;
+
+      stream.setf(std::ios::fixed);
+      stream.precision(1);
+      stream << "buffer " << this->buffering_message;
+
+      if (progress.file_lines > 0)
+        stream << " · read " << 100.0 * progress.read_lines / progress.file_lines << "%";
+      else if (progress.file_bytes > 0)
+        stream << " · read " << 100.0 * progress.read_bytes / progress.file_bytes << "%";
+
+      stream << " · read-ahead " << progress.read_ahead_bytes / 1048576.0 << "MB"
+             << " · margin " << data::floating_seconds(progress.read_margin) << "s"
+             << " (out of order " << data::floating_seconds(progress.out_of_order) << "s)";
+
+      if (!progress.first_time.is_not_a_date_time() && !progress.last_time.is_not_a_date_time() && (progress.last_time > progress.first_time)) {
+        double const covered = data::floating_seconds(timings.simulation_time - progress.first_time);
+        double const total   = data::floating_seconds(progress.last_time - progress.first_time);
+
+        stream << " · covered " << glm::clamp(100.0 * covered / total, 0.0, 100.0) << "%";
+
+        if ((simulation_rate > 0.0) && (timings.simulation_time < progress.last_time)) {
+          double const remaining = data::floating_seconds(progress.last_time - timings.simulation_time) / simulation_rate;
+          stream << " · ETA " << data::seconds(static_cast< long >(remaining));
+        }
+      }
+
+      this->progress_message = stream.str();
+    }
+
     void info::logic(data::timings const& timings) {
       view::object::logic(timings);
 
@@ -56,6 +88,7 @@ namespace logoprism {
       if (!this->is_dead())
         renderer.render(this->message, this->position, text::anchor::CENTER_CENTER, message_font, this->get_color());
       renderer.render(this->timing_message, this->position + glm::vec2(0.0f, -this->dimension.y / 2.0f), text::anchor::TOP_CENTER, time_font, this->get_color(1.0));
+      renderer.render(this->progress_message, this->position + glm::vec2(0.0f, this->dimension.y / 2.0f), text::anchor::BOTTOM_CENTER, time_font, this->get_color(1.0));
     }
 
   }
@@ -2,6 +2,7 @@
 #define __LOGOPRISM_VIEW_SPEED_HPP__
 
 #include "logoprism/view/object.hpp"
+#include "logoprism/data/reader_base.hpp"
 
 namespace logoprism {
   namespace view {
@@ -14,6 +15,15 @@ namespace logoprism {
 
       void set_buffer_percentage(size_t const buffer_percentage);
 
+      /**
+       * Updates the progress line with the reading progress, the simulated time coverage and the remaining time estimate.
+       *
+       * @param progress        the reading progress through the file
+       * @param timings         the current timings
+       * @param simulation_rate the measured number of simulated seconds per real second
+       */
+      void set_progress(data::reading_progress const& progress, data::timings const& timings, double const simulation_rate);
+
       void logic(data::timings const& timings);
       void draw(renderer::base& renderer, data::timings const& timings);
 
@@ -21,6 +31,7 @@ namespace logoprism {
         std::string message;
         std::string timing_message;
         std::string buffering_message;
+        std::string progress_message;
     };
 
   }
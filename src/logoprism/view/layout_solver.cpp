@@ -0,0 +1,78 @@
+#include "logoprism/view/layout_solver.hpp"
+
+#include <cmath>
+
+namespace logoprism {
+  namespace view {
+
+    layout_solver::layout_solver() :
+      direction(0.0f, 0.0f)
+    {}
+
+    void layout_solver::reset(glm::vec2 const& direction, std::vector< view::object* > const& objects) {
+      size_t const count = objects.size();
+
+      this->direction = direction;
+      this->objects   = objects;
+
+      this->x.resize(count);
+      this->y.resize(count);
+      this->fixed.resize(count);
+
+      for (size_t i = 0; i < count; ++i) {
+        this->x[i]     = objects[i]->position.x;
+        this->y[i]     = objects[i]->position.y;
+        this->fixed[i] = objects[i]->position_fixed ? 1.0f : 0.0f;
+      }
+    }
+
+    void layout_solver::clear() {
+      this->objects.clear();
+      this->x.clear();
+      this->y.clear();
+      this->fixed.clear();
+    }
+
+    float layout_solver::factor(data::timings const& timings) {
+      // something like square-square-root of the timelapse * speed...
+      return static_cast< float >(std::min(1.0, 2.0 * std::sqrt(std::sqrt(data::floating_seconds(timings.timelapse * std::max(1.0, timings.simulation_speed))))));
+    }
+
+    void layout_solver::step(float const factor) {
+      size_t const count = this->objects.size();
+      if (count < 2)
+        return;
+
+      float* const       x           = this->x.data();
+      float* const       y           = this->y.data();
+      float const* const fixed       = this->fixed.data();
+      float const        direction_x = this->direction.x;
+      float const        direction_y = this->direction.y;
+
+      // the springs are relaxed in place in two passes, the even springs and then the odd ones, so that no object is moved
+      // by two springs at once and the chain settles even when the whole extension is relaxed, while the springs of a
+      // pass do not share any object and can be relaxed independently of each other
+      for (size_t parity = 0; parity < 2; ++parity) {
+        for (size_t i = parity; i + 1 < count; i += 2) {
+          float const variation_x = (direction_x - (x[i + 1] - x[i])) * factor;
+          float const variation_y = (direction_y - (y[i + 1] - y[i])) * factor;
+
+          // the spring moves its next end if it is free, or its previous end if the next one is fixed
+          float const next_free     = 1.0f - fixed[i + 1];
+          float const previous_free = (1.0f - fixed[i]) * fixed[i + 1];
+
+          x[i + 1] += next_free * variation_x;
+          y[i + 1] += next_free * variation_y;
+          x[i]     -= previous_free * variation_x;
+          y[i]     -= previous_free * variation_y;
+        }
+      }
+
+      for (size_t i = 0; i < count; ++i) {
+        this->objects[i]->position.x = x[i];
+        this->objects[i]->position.y = y[i];
+      }
+    }
+
+  }
+}
@@ -0,0 +1,53 @@
+#ifndef __LOGOPRISM_VIEW_LAYOUT_SOLVER_HPP__
+#define __LOGOPRISM_VIEW_LAYOUT_SOLVER_HPP__
+
+#include "logoprism/data/types.hpp"
+#include "logoprism/data/datetime.hpp"
+#include "logoprism/view/object.hpp"
+
+#include <vector>
+
+namespace logoprism {
+  namespace view {
+
+    /**
+     * Relaxation of a chain of objects linked by springs, each spring pulling its two ends towards the same target
+     * direction. The positions and the fixed flags are kept in contiguous arrays, and the springs are relaxed in place in two
+     * branchless loops over the arrays, the even springs and then the odd ones, whose iterations are independent.
+     */
+    struct layout_solver {
+      public:
+        layout_solver();
+
+        /**
+         * Replaces the chain of objects, taking their current positions.
+         * @param direction the target vector between two consecutive objects
+         * @param objects   the chained objects, usually with fixed objects at both ends
+         */
+        void reset(glm::vec2 const& direction, std::vector< view::object* > const& objects);
+
+        /** discards the chain of objects */
+        void clear();
+
+        /**
+         * Relaxes the springs and moves the objects to their new positions.
+         * @param factor the fraction of the springs' extension to relax, as given by layout_solver::factor
+         */
+        void step(float const factor);
+
+        /** the relaxation factor for the given frame timings, from the timelapse and the simulation speed */
+        static float factor(data::timings const& timings);
+
+      protected:
+        glm::vec2 direction;
+
+        std::vector< view::object* > objects;
+        std::vector< float >         x;
+        std::vector< float >         y;
+        std::vector< float >         fixed;
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_VIEW_LAYOUT_SOLVER_HPP__
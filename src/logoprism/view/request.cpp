@@ -46,24 +46,14 @@ namespace logoprism {
         double curve_start = std::max(0.0, std::min(1.0, offset_start));
         double curve_end   = std::max(0.0, std::min(1.0, offset_end));
 
-        glm::vec2 middle_point   = (this->position_left + this->position_center) / 2.0f;
-        glm::vec2 control_point0 = this->position_left + glm::vec2(middle_point.x - this->position_left.x, 0.0);
-        glm::vec2 control_point1 = this->position_center + glm::vec2(middle_point.x - this->position_center.x, 0.0);
-
-        this->bezier_left = view::bezier(view::bezier::control_points_type(this->position_left, control_point0, control_point1, this->position_center),
-                                         glm::vec2(curve_start, curve_end), glm::vec2(1.0, 0.75));
+        this->bezier_left.update(this->position_left, this->position_center, glm::vec2(curve_start, curve_end), glm::vec2(1.0, 0.75));
       }
 
       if (offset_start <= 0.0) {
         double curve_start = 1.0 + std::max(-1.0, std::min(0.0, offset_start));
         double curve_end   = 1.0 + std::max(-1.0, std::min(0.0, offset_end));
 
-        glm::vec2 middle_point   = (this->position_center + this->position_right) / 2.0f;
-        glm::vec2 control_point0 = this->position_center + glm::vec2(middle_point.x - this->position_center.x, 0.0);
-        glm::vec2 control_point1 = this->position_right + glm::vec2(middle_point.x - this->position_right.x, 0.0);
-
-        this->bezier_right = view::bezier(view::bezier::control_points_type(this->position_center, control_point0, control_point1, this->position_right),
-                                          glm::vec2(curve_start, curve_end), glm::vec2(0.0, 0.25));
+        this->bezier_right.update(this->position_center, this->position_right, glm::vec2(curve_start, curve_end), glm::vec2(0.0, 0.25));
       }
     } // logic
 
@@ -73,15 +63,11 @@ namespace logoprism {
       if (this->is_dead())
         return;
 
-      double const offset_start = data::floating_seconds(this->offset_start(timings));
-      double const offset_end   = data::floating_seconds(this->offset_end(timings));
-
-      if (offset_end >= 0.0)
-        renderer.render(this->bezier_left.control_points, this->bezier_left.range, this->bezier_left.fading, this->get_color(), this->width_factor);
-
-      if (offset_start <= 0.0)
-        renderer.render(this->bezier_right.control_points, this->bezier_right.range, this->bezier_right.fading, this->get_color(), this->width_factor);
+      if (this->has_left(timings))
+        renderer.render(this->bezier_left, this->get_color(), this->width_factor);
 
+      if (this->has_right(timings))
+        renderer.render(this->bezier_right, this->get_color(), this->width_factor);
     }
 
     void request::draw_status(renderer::base& renderer, data::timings const& timings) {
@@ -8,20 +8,7 @@
 namespace logoprism {
   namespace view {
 
-    struct bezier {
-      typedef std::tuple< glm::vec2, glm::vec2, glm::vec2, glm::vec2 > control_points_type;
-
-      bezier() : control_points(), range(), fading() {}
-      bezier(control_points_type const& control_points, glm::vec2 const& range, glm::vec2 const& fading) :
-        control_points(control_points),
-        range(range),
-        fading(fading)
-      {}
-
-      control_points_type control_points;
-      glm::vec2           range;
-      glm::vec2           fading;
-    };
+    typedef renderer::curve bezier;
 
     struct request : public view::object {
       request(data::request const& request);
@@ -42,6 +29,16 @@ namespace logoprism {
         return data::floating_seconds(this->offset_start(timings)) > 2.0;
       }
 
+      /** whether the curve from the source to the worker is visible */
+      bool has_left(data::timings const& timings) const {
+        return data::floating_seconds(this->offset_end(timings)) >= 0.0;
+      }
+
+      /** whether the curve from the worker to the target is visible */
+      bool has_right(data::timings const& timings) const {
+        return data::floating_seconds(this->offset_start(timings)) <= 0.0;
+      }
+
       bool operator<(view::request const& other) const {
         return this->data < other.data;
       }
@@ -57,6 +54,10 @@ namespace logoprism {
       data::request const data;
       float const         width_factor;
 
+      view::slot_handle node_left;
+      view::slot_handle node_center;
+      view::slot_handle node_right;
+
       glm::vec2 position_left;
       glm::vec2 position_center;
       glm::vec2 position_right;
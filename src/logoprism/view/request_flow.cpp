@@ -1,11 +1,14 @@
 #include "logoprism/view/request_flow.hpp"
 #include "logoprism/data/color.hpp"
+#include "logoprism/utils/thread_pool.hpp"
+#include "logoprism/config/config.hpp"
 
 namespace logoprism {
   namespace view {
 
     request_flow::request_flow(glm::vec2 const& position, glm::vec2 const& dimension, float keep_alive) :
       view::object(position, dimension),
+      lod_budget(static_cast< size_t >(config::get("display.lod-budget", 2000))),
       top_left(position.x, position.y),
       bottom_right(position.x + dimension.x, position.y + dimension.y),
       top_right(bottom_right.x, top_left.y),
@@ -25,6 +28,35 @@ namespace logoprism {
                      [](data::request const& r) { return r.worker; });
     }
 
+    void request_flow::set_requests(data::keyframe&& keyframe) {
+      std::swap(this->requests, keyframe.requests);
+      std::swap(this->workers, keyframe.workers);
+    }
+
+    request_flow::layout_t request_flow::layout() {
+      layout_t layout;
+
+      layout.left   = this->items_left.layout();
+      layout.center = this->items_center.layout();
+      layout.right  = this->items_right.layout();
+
+      return layout;
+    }
+
+    void request_flow::restore(layout_t const& layout) {
+      this->requests.clear();
+      this->workers.clear();
+      this->request_views.clear();
+      this->worker_views.clear();
+      this->request_handles.clear();
+      this->worker_handles.clear();
+      this->bundles.clear();
+
+      this->items_left.restore(layout.left);
+      this->items_center.restore(layout.center);
+      this->items_right.restore(layout.right);
+    }
+
     void request_flow::logic(data::timings const& timings) {
       object::logic(timings);
 
@@ -33,85 +65,123 @@ namespace logoprism {
 
       if (timings.is_keyframe) {
         for (auto& request : this->requests) {
-          if (this->request_views.find(request) != this->request_views.end())
+          if (this->request_handles.find(request.sequence) != this->request_handles.end())
             continue;
 
           view::request view(request);
           if (!view.is_processing(timings))
             continue;
 
-          this->request_views.insert(std::make_pair(request, std::move(view)));
+          // attach the request strings once, their positions are then read directly from the string lists nodes
+          view.node_left   = this->items_left.attach(request.source);
+          view.node_center = this->items_center.attach(request.worker);
+          view.node_right  = this->items_right.attach(request.target);
+
+          this->request_handles[request.sequence] = this->request_views.emplace(std::move(view));
 
           data::duration worker_litetime = data::microseconds(static_cast< uint64_t >(this->keep_alive * 1000000));
           if (!request.keep_alive)
             worker_litetime = request.duration;
 
-          if (this->worker_views.find(request.worker) != this->worker_views.end())
-            this->worker_views.erase(request.worker);
+          auto const worker = this->worker_handles.find(request.worker);
+          if (worker != this->worker_handles.end()) {
+            this->items_center.detach(this->worker_views.get(worker->second)->node_center);
+            this->worker_views.erase(worker->second);
+          }
 
-          this->worker_views.insert(std::make_pair(request.worker, view::worker(worker_litetime, request)));
+          view::slot_handle const handle = this->worker_views.emplace(worker_litetime, request);
+          this->worker_views.get(handle)->node_center = this->items_center.attach(request.worker);
+          this->worker_handles[request.worker]        = handle;
         }
 
-        for (auto it = std::begin(this->request_views), end = std::end(this->request_views); it != end;) {
-          if (it->second.is_complete(timings) || (this->requests.find(it->first) == this->requests.end()))
-            it->second.kill();
-
-          if (it->second.is_dead())
-            this->request_views.erase(it++);
-          else
-            ++it;
+        // erasing a view moves the last one in its place, so only move forward when the view is kept
+        for (size_t i = 0; i < this->request_views.size();) {
+          view::request& view = this->request_views[i];
+
+          if (view.is_complete(timings) || (this->requests.find(view.data) == this->requests.end()))
+            view.kill();
+
+          if (view.is_dead()) {
+            this->items_left.detach(view.node_left);
+            this->items_center.detach(view.node_center);
+            this->items_right.detach(view.node_right);
+            this->request_handles.erase(view.data.sequence);
+            this->request_views.erase(this->request_views.handle_at(i));
+          } else {
+            ++i;
+          }
         }
 
-        for (auto it = std::begin(this->worker_views), end = std::end(this->worker_views); it != end;) {
-          if (this->workers.find(it->first) == this->workers.end())
-            it->second.kill();
+        for (size_t i = 0; i < this->worker_views.size();) {
+          view::worker& view = this->worker_views[i];
+
+          if (this->workers.find(view.data.worker) == this->workers.end())
+            view.kill();
 
-          if (it->second.is_dead())
-            this->worker_views.erase(it++);
-          else
-            ++it;
+          if (view.is_dead()) {
+            this->items_center.detach(view.node_center);
+            this->worker_handles.erase(view.data.worker);
+            this->worker_views.erase(this->worker_views.handle_at(i));
+          } else {
+            ++i;
+          }
         }
 
-        std::set< std::string >& items_left   = this->items_left.get_items();
-        std::set< std::string >& items_center = this->items_center.get_items();
-        std::set< std::string >& items_right  = this->items_right.get_items();
+        // the item lists only live until the end of the frame, allocate them from the frame arena
+        utils::arena& arena = utils::arena::frame();
 
-        items_left.clear();
-        items_center.clear();
-        items_right.clear();
+        view::string_list::items_t items_left(arena);
+        view::string_list::items_t items_center(arena);
+        view::string_list::items_t items_right(arena);
 
-        std::transform(std::begin(this->request_views), std::end(this->request_views), std::inserter(items_left, std::end(items_left)),
-                       [](std::pair< data::request, view::request > const& pair) { return pair.first.source; });
+        items_left.reserve(this->request_views.size());
+        items_center.reserve(this->request_views.size());
+        items_right.reserve(this->request_views.size());
 
-        std::transform(std::begin(this->request_views), std::end(this->request_views), std::inserter(items_center, std::end(items_center)),
-                       [](std::pair< data::request, view::request > const& pair) { return pair.first.worker; });
+        for (auto const& view : this->request_views) {
+          items_left.push_back(&view.data.source);
+          items_center.push_back(&view.data.worker);
+          items_right.push_back(&view.data.target);
+        }
 
-        std::transform(std::begin(this->request_views), std::end(this->request_views), std::inserter(items_right, std::end(items_right)),
-                       [](std::pair< data::request, view::request > const& pair) { return pair.first.target; });
+        this->items_left.set_items(items_left);
+        this->items_center.set_items(items_center);
+        this->items_right.set_items(items_right);
       }
 
-      for (auto& pair : this->worker_views) {
-        pair.second.logic(timings);
-      }
+      // the views logic is independent from one view to another, update them in parallel
+      utils::thread_pool& pool = utils::thread_pool::shared();
 
-      for (auto& pair : this->request_views) {
-        pair.second.logic(timings);
-      }
+      pool.parallel_for(this->worker_views.size(), [&](size_t const begin, size_t const end) {
+                          for (size_t i = begin; i < end; ++i) {
+                            this->worker_views[i].logic(timings);
+                          }
+                        });
+
+      pool.parallel_for(this->request_views.size(), [&](size_t const begin, size_t const end) {
+                          for (size_t i = begin; i < end; ++i) {
+                            this->request_views[i].logic(timings);
+                          }
+                        });
 
       this->items_left.logic(timings);
       this->items_center.logic(timings);
       this->items_right.logic(timings);
 
-      for (auto& pair : this->request_views) {
-        pair.second.position_left   = this->items_left.get_position(pair.first.source);
-        pair.second.position_center = this->items_center.get_position(pair.first.worker);
-        pair.second.position_right  = this->items_right.get_position(pair.first.target);
-      }
+      pool.parallel_for(this->request_views.size(), [&](size_t const begin, size_t const end) {
+                          for (size_t i = begin; i < end; ++i) {
+                            view::request& view = this->request_views[i];
+
+                            view.position_left   = this->items_left.get_position(view.node_left);
+                            view.position_center = this->items_center.get_position(view.node_center);
+                            view.position_right  = this->items_right.get_position(view.node_right);
+                          }
+                        });
 
-      for (auto& pair : this->worker_views) {
-        pair.second.position_center = this->items_center.get_position(pair.first);
-        pair.second.position_left   = pair.second.position_center - glm::vec2(100.0, 0.0);
-        pair.second.position_right  = pair.second.position_center + glm::vec2(100.0, 0.0);
+      for (auto& view : this->worker_views) {
+        view.position_center = this->items_center.get_position(view.node_center);
+        view.position_left   = view.position_center - glm::vec2(100.0, 0.0);
+        view.position_right  = view.position_center + glm::vec2(100.0, 0.0);
       }
     } // logic
 
@@ -121,21 +191,98 @@ namespace logoprism {
       if (this->is_dead())
         return;
 
-      for (auto& pair : this->worker_views) {
-        pair.second.draw(renderer, timings);
+      for (auto& view : this->worker_views) {
+        view.draw(renderer, timings);
       }
 
-      for (auto& pair : this->request_views) {
-        pair.second.draw(renderer, timings);
-      }
+      if ((this->lod_budget > 0) && (this->request_views.size() > this->lod_budget)) {
+        this->draw_bundles(renderer, timings);
+      } else {
+        this->bundles.clear();
+
+        for (auto& view : this->request_views) {
+          view.draw(renderer, timings);
+        }
 
-      for (auto& pair : this->request_views) {
-        pair.second.draw_status(renderer, timings);
+        for (auto& view : this->request_views) {
+          view.draw_status(renderer, timings);
+        }
       }
 
       this->items_left.draw(renderer, timings);
       this->items_right.draw(renderer, timings);
     }
 
+    void request_flow::draw_bundles(renderer::base& renderer, data::timings const& timings) {
+      for (auto& pair : this->bundles) {
+        pair.second.count = 0;
+      }
+
+      // group the visible requests by nodes, merging the ranges of their curves
+      for (auto& view : this->request_views) {
+        if (view.is_dead())
+          continue;
+
+        bool const has_left  = view.has_left(timings);
+        bool const has_right = view.has_right(timings);
+
+        bundle_key const key = { this->items_left.get_view(view.node_left), this->items_center.get_view(view.node_center), this->items_right.get_view(view.node_right) };
+        bundle&          b   = this->bundles[key];
+
+        if (b.count == 0) {
+          b.bytes       = 0;
+          b.first       = &view;
+          b.range_left  = view.bezier_left.range;
+          b.range_right = view.bezier_right.range;
+          b.has_left    = false;
+          b.has_right   = false;
+        }
+
+        if (has_left) {
+          b.range_left = b.has_left ? glm::vec2(std::min(b.range_left.x, view.bezier_left.range.x), std::max(b.range_left.y, view.bezier_left.range.y)) : view.bezier_left.range;
+          b.has_left   = true;
+        }
+
+        if (has_right) {
+          b.range_right = b.has_right ? glm::vec2(std::min(b.range_right.x, view.bezier_right.range.x), std::max(b.range_right.y, view.bezier_right.range.y)) : view.bezier_right.range;
+          b.has_right   = true;
+        }
+
+        b.count += 1;
+        b.bytes += view.data.size_in_bytes;
+      }
+
+      for (auto it = std::begin(this->bundles), end = std::end(this->bundles); it != end;) {
+        bundle& b = it->second;
+
+        if (b.count == 0) {
+          this->bundles.erase(it++);
+          continue;
+        }
+        ++it;
+
+        // single requests are drawn as usual, with their status
+        if (b.count == 1) {
+          b.first->draw(renderer, timings);
+          b.first->draw_status(renderer, timings);
+          continue;
+        }
+
+        float const width = std::max(1.0, (std::log(static_cast< double >(std::max< uint64_t >(b.bytes, 1))) / std::log(10) - 2.0) * 3.0);
+        glm::vec4   color = b.first->get_color();
+        color.w = std::min(1.0f, color.w * (0.5f + 0.25f * std::log2(static_cast< float >(b.count))));
+
+        if (b.has_left) {
+          b.bezier_left.update(b.first->position_left, b.first->position_center, b.range_left, b.first->bezier_left.fading);
+          renderer.render(b.bezier_left, color, width);
+        }
+
+        if (b.has_right) {
+          b.bezier_right.update(b.first->position_center, b.first->position_right, b.range_right, b.first->bezier_right.fading);
+          renderer.render(b.bezier_right, color, width);
+        }
+      }
+    } // draw_bundles
+
   }
 }
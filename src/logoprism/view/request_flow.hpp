@@ -3,27 +3,97 @@
 
 #include "logoprism/view/request.hpp"
 #include "logoprism/data/request.hpp"
+#include "logoprism/data/reader_base.hpp"
 #include "logoprism/view/worker.hpp"
 #include "logoprism/view/object.hpp"
 #include "logoprism/view/string_list.hpp"
+#include "logoprism/view/slot_map.hpp"
+
+#include <unordered_map>
 
 namespace logoprism {
   namespace view {
 
     struct request_flow : public view::object {
+      /** positions of the source, worker and target string views */
+      struct layout_t {
+        view::string_list::layout_t left;
+        view::string_list::layout_t center;
+        view::string_list::layout_t right;
+      };
+
       request_flow(glm::vec2 const& position, glm::vec2 const& dimension, float keep_alive);
 
       void set_requests(data::requests const& requests);
 
+      /** takes the requests and workers of a keyframe, without copying them */
+      void set_requests(data::keyframe&& keyframe);
+
+      /** get the current layout of the string views */
+      layout_t layout();
+
+      /** discards every request and worker view and replaces the string views with the ones from the given layout */
+      void restore(layout_t const& layout);
+
       void logic(data::timings const& timings);
+
+      /**
+       * Draws the workers and requests. Above the level of detail budget, the requests sharing the same source, worker and
+       * target nodes are bundled and drawn as a single edge, whose width reflects their total size and whose opacity
+       * reflects their count.
+       */
       void draw(renderer::base& renderer, data::timings const& timings);
 
+      protected:
+        /**
+         * The string views a bundle of requests goes through, so that the requests whose strings are collapsed into the
+         * same label are bundled together.
+         */
+        struct bundle_key {
+          bool operator==(bundle_key const& other) const { return this->left == other.left && this->center == other.center && this->right == other.right; }
+
+          view::string const* left;
+          view::string const* center;
+          view::string const* right;
+        };
+
+        struct bundle_hash {
+          size_t operator()(bundle_key const& key) const {
+            std::hash< view::string const* > const hash;
+            return (hash(key.left) * 31 + hash(key.center)) * 31 + hash(key.right);
+          }
+        };
+
+        /** requests drawn as a single edge, the curves are kept from one frame to another so that they stay tessellated */
+        struct bundle {
+          bundle() : count(0), bytes(0), first(NULL), range_left(), range_right(), has_left(false), has_right(false) {}
+
+          size_t         count;
+          uint64_t       bytes;
+          view::request* first;
+
+          glm::vec2 range_left;
+          glm::vec2 range_right;
+          bool      has_left;
+          bool      has_right;
+
+          view::bezier bezier_left;
+          view::bezier bezier_right;
+        };
+
+        void draw_bundles(renderer::base& renderer, data::timings const& timings);
+
+        size_t const                                          lod_budget;
+        std::unordered_map< bundle_key, bundle, bundle_hash > bundles;
+
       protected:
         std::set< data::request > requests;
         std::set< std::string >   workers;
 
-        std::map< data::request, view::request > request_views;
-        std::map< std::string, view::worker >    worker_views;
+        view::slot_map< view::request >                      request_views;
+        view::slot_map< view::worker >                       worker_views;
+        std::unordered_map< size_t, view::slot_handle >      request_handles;
+        std::unordered_map< std::string, view::slot_handle > worker_handles;
 
         glm::vec2 top_left;
         glm::vec2 bottom_right;
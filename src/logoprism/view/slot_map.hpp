@@ -0,0 +1,194 @@
+#ifndef __LOGOPRISM_VIEW_SLOT_MAP_HPP__
+#define __LOGOPRISM_VIEW_SLOT_MAP_HPP__
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+
+namespace logoprism {
+  namespace view {
+
+    /**
+     * Generational handle to an object stored in a slot_map. A handle stays valid until its object is erased, and is never
+     * confused with an object inserted later in the same slot.
+     */
+    struct slot_handle {
+      slot_handle() : index(static_cast< uint32_t >(-1)), generation(0) {}
+      slot_handle(uint32_t const index, uint32_t const generation) :
+        index(index),
+        generation(generation)
+      {}
+
+      bool operator==(slot_handle const& other) const { return this->index == other.index && this->generation == other.generation; }
+      bool operator!=(slot_handle const& other) const { return !(*this == other); }
+
+      uint32_t index;
+      uint32_t generation;
+    };
+
+    /**
+     * Dense storage of objects addressed by generational handles. The objects are kept contiguous in memory, in no particular
+     * order, so that they can be iterated without pointer chasing, and the slots of erased objects are reused through a free
+     * list. Erasing an object moves the last one in its place.
+     *
+     * The objects are constructed in place in manually managed storage, as views are not assignable.
+     */
+    template< typename T >
+    struct slot_map {
+      public:
+        typedef slot_handle handle;
+        typedef T*          iterator;
+        typedef T const*    const_iterator;
+
+        slot_map() :
+          storage(),
+          capacity(0),
+          count(0),
+          slots(),
+          dense_slots(),
+          free_slot(none)
+        {}
+
+        ~slot_map() {
+          this->clear();
+        }
+
+        slot_map(slot_map const&) = delete;
+        slot_map& operator=(slot_map const&) = delete;
+
+        /** constructs a new object in place and returns its handle */
+        template< typename ... Arguments >
+        handle emplace(Arguments&& ... arguments) {
+          if (this->count == this->capacity)
+            this->reserve(std::max< size_t >(16, this->capacity * 2));
+
+          new (this->data() + this->count)T(std::forward< Arguments >(arguments) ...);
+
+          // reuse a free slot if any, or create a new one
+          uint32_t index = this->free_slot;
+          if (index == none) {
+            index = static_cast< uint32_t >(this->slots.size());
+            this->slots.push_back(slot());
+          } else {
+            this->free_slot = this->slots[index].dense;
+          }
+
+          this->slots[index].dense = static_cast< uint32_t >(this->count);
+          this->dense_slots.push_back(index);
+          ++this->count;
+
+          return handle(index, this->slots[index].generation);
+        }
+
+        /** whether the handle still refers to a stored object */
+        bool contains(handle const& h) const {
+          return h.index < this->slots.size() && this->slots[h.index].generation == h.generation;
+        }
+
+        /** the object the handle refers to, or nullptr if it has been erased */
+        T* get(handle const& h) {
+          return this->contains(h) ? this->data() + this->slots[h.index].dense : nullptr;
+        }
+
+        T const* get(handle const& h) const {
+          return this->contains(h) ? this->data() + this->slots[h.index].dense : nullptr;
+        }
+
+        /** the handle of the object at the given position in the dense storage */
+        handle handle_at(size_t const position) const {
+          uint32_t const index = this->dense_slots[position];
+          return handle(index, this->slots[index].generation);
+        }
+
+        /** erases the object the handle refers to, if any, moving the last object in its place */
+        void erase(handle const& h) {
+          if (!this->contains(h))
+            return;
+
+          size_t const position = this->slots[h.index].dense;
+          size_t const last     = this->count - 1;
+          T* const     objects  = this->data();
+
+          objects[position].~T();
+          if (position != last) {
+            new (objects + position)T(std::move(objects[last]));
+            objects[last].~T();
+
+            uint32_t const moved = this->dense_slots[last];
+            this->dense_slots[position] = moved;
+            this->slots[moved].dense    = static_cast< uint32_t >(position);
+          }
+
+          this->dense_slots.pop_back();
+          --this->count;
+
+          // invalidate the outstanding handles and put the slot in the free list
+          this->slots[h.index].generation += 1;
+          this->slots[h.index].dense       = this->free_slot;
+          this->free_slot                  = h.index;
+        }
+
+        /** erases every object, invalidating every handle */
+        void clear() {
+          while (this->count > 0)
+            this->erase(this->handle_at(this->count - 1));
+        }
+
+        size_t size() const { return this->count; }
+        bool   empty() const { return this->count == 0; }
+
+        iterator       begin() { return this->data(); }
+        iterator       end() { return this->data() + this->count; }
+        const_iterator begin() const { return this->data(); }
+        const_iterator end() const { return this->data() + this->count; }
+
+        T&       operator[](size_t const position) { return this->data()[position]; }
+        T const& operator[](size_t const position) const { return this->data()[position]; }
+
+      protected:
+        typedef typename std::aligned_storage< sizeof(T), std::alignment_of< T >::value >::type storage_type;
+
+        static uint32_t const none = static_cast< uint32_t >(-1);
+
+        struct slot {
+          slot() : dense(none), generation(0) {}
+
+          /** the position of the object in the dense storage, or the next free slot when free */
+          uint32_t dense;
+          uint32_t generation;
+        };
+
+        std::unique_ptr< storage_type[] > storage;
+        size_t                            capacity;
+        size_t                            count;
+
+        std::vector< slot >     slots;
+        std::vector< uint32_t > dense_slots;
+        uint32_t                free_slot;
+
+        T*       data() { return reinterpret_cast< T* >(this->storage.get()); }
+        T const* data() const { return reinterpret_cast< T const* >(this->storage.get()); }
+
+        /** grows the storage, moving the objects to the new one */
+        void reserve(size_t const capacity) {
+          std::unique_ptr< storage_type[] > storage(new storage_type[capacity]);
+          T* const                          objects = reinterpret_cast< T* >(storage.get());
+
+          for (size_t i = 0; i < this->count; ++i) {
+            new (objects + i)T(std::move(this->data()[i]));
+            this->data()[i].~T();
+          }
+
+          this->storage  = std::move(storage);
+          this->capacity = capacity;
+        }
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_VIEW_SLOT_MAP_HPP__
@@ -13,7 +13,8 @@ namespace logoprism {
 
     string::string(std::string const& data, view::alignment const alignment) :
       data(data),
-      alignment(alignment) {}
+      alignment(alignment),
+      measured(false) {}
 
     string::~string() {}
 
@@ -27,30 +28,40 @@ namespace logoprism {
     }
 
     void string::draw(renderer::base& renderer, data::timings const& timings) {
-      static std::string const string_font = config::get("display.fonts.node-name", "monospace 10");
-
       view::object::draw(renderer, timings);
 
       if (this->is_dead())
         return;
 
-      text::anchor anchor = text::anchor::CENTER_LEFT;
-      switch (this->alignment) {
-        case view::alignment::left:
-          anchor = text::anchor::CENTER_LEFT;
-          break;
+      this->measure(renderer);
+      renderer.render(this->data, this->position, this->anchor(), string::font(), this->get_color());
+    }
+
+    void string::measure(renderer::base& renderer) {
+      if (this->measured)
+        return;
 
+      this->dimension = renderer.measure(this->data, this->anchor(), string::font());
+      this->measured  = true;
+    }
+
+    text::anchor string::anchor(view::alignment const alignment) {
+      switch (alignment) {
         case view::alignment::center:
-          anchor = text::anchor::CENTER_CENTER;
-          break;
+          return text::anchor::CENTER_CENTER;
 
         case view::alignment::right:
-          anchor = text::anchor::CENTER_RIGHT;
-          break;
+          return text::anchor::CENTER_RIGHT;
+
+        default:
+          return text::anchor::CENTER_LEFT;
       }
+    }
+
+    std::string const& string::font() {
+      static std::string const string_font = config::get("display.fonts.node-name", "monospace 10");
 
-      this->dimension = renderer.measure(this->data, anchor, string_font);
-      renderer.render(this->data, this->position, anchor, string_font, this->get_color());
+      return string_font;
     }
 
   }
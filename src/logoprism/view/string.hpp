@@ -12,7 +12,7 @@ namespace logoprism {
     };
 
     struct string : public view::object {
-      string() {}
+      string() : alignment(view::alignment::left), measured(false) {}
 
       string(std::string const& data, view::alignment const alignment=view::alignment::left);
       ~string();
@@ -20,9 +20,22 @@ namespace logoprism {
       void logic(data::timings const& timings);
       void draw(renderer::base& renderer, data::timings const& timings);
 
+      /** measures the string, updating its dimension, without drawing it, only the first time as its text never changes */
+      void measure(renderer::base& renderer);
+
+      /** the text anchor matching the string alignment */
+      text::anchor        anchor() const { return string::anchor(this->alignment); }
+      static text::anchor anchor(view::alignment const alignment);
+
+      /** the font used to render the string views */
+      static std::string const& font();
+
       public:
         std::string     data;
         view::alignment alignment;
+
+      protected:
+        bool measured;
     };
 
   }
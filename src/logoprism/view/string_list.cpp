@@ -1,5 +1,6 @@
 #include "logoprism/view/string_list.hpp"
-#include <boost/algorithm/string.hpp>
+
+#include <limits>
 
 namespace logoprism {
   namespace view {
@@ -7,7 +8,8 @@ namespace logoprism {
     string_list::string_list(glm::vec2 const& top, glm::vec2 const& bottom, std::string const& separator, view::alignment alignment) :
       separator(separator),
       alignment(alignment),
-      token_count(0) {
+      token_count(0),
+      trie(separator) {
       this->top.position          = top;
       this->top.position_fixed    = true;
       this->bottom.position       = bottom;
@@ -15,56 +17,118 @@ namespace logoprism {
     }
 
     void string_list::refresh_bonds() {
-      this->bonds.clear();
       size_t    view_count     = std::count_if(this->views.begin(), this->views.end(), [](view_map_t::value_type& pair) { return !pair.second.is_dying(); }) + 1;
       glm::vec2 sort_direction = (this->bottom.position - this->top.position) / (static_cast< float >(view_count));
 
-      view::bond bond(sort_direction);
-      bond.prev = &this->top;
+      // chain the living views between the top and the bottom
+      std::vector< view::object* > chain;
+      chain.reserve(view_count + 1);
+
+      chain.push_back(&this->top);
       for (auto& pair : this->views) {
-        bond.next = &pair.second;
+        if (!pair.second.is_dying())
+          chain.push_back(&pair.second);
+      }
+      chain.push_back(&this->bottom);
 
-        if (pair.second.is_dying())
-          continue;
+      this->solver.reset(sort_direction, chain);
+    }
 
-        this->bonds.push_back(bond);
-        bond.prev = bond.next;
+    size_t string_list::token_limit() {
+      return this->token_count;
+    }
+
+    void string_list::set_token_limit(size_t const token_count) {
+      this->token_count = token_count;
+
+      // the labels of the new level are already known by the trie, views are created for them at the next keyframe
+      for (auto& node : this->nodes) {
+        node.name = this->trie.label(node.leaf, this->token_count);
       }
+      this->resolve_nodes();
+    }
+
+    view::slot_handle string_list::attach(std::string const& string) {
+      auto const it = this->node_handles.find(string);
+      if (it != this->node_handles.end()) {
+        this->nodes.get(it->second)->references += 1;
+        return it->second;
+      }
+
+      uint32_t const          leaf   = this->trie.acquire(string);
+      view::slot_handle const handle = this->nodes.emplace(string, leaf, this->trie.label(leaf, this->token_count));
+      this->node_handles.insert(std::make_pair(string, handle));
 
-      bond.next = &this->bottom;
-      this->bonds.push_back(bond);
+      node&      node = *this->nodes.get(handle);
+      auto const view = this->views.find(node.name);
+      node.view     = (view == this->views.end()) ? NULL : &view->second;
+      node.position = this->bottom.position;
+
+      return handle;
     }
 
-    std::string string_list::split(std::string const& string) {
-      if (this->token_count > 0) {
-        std::vector< boost::iterator_range< std::string::const_iterator > > split_ranges;
-        boost::split(split_ranges, string, boost::is_any_of(this->separator), boost::token_compress_on);
+    void string_list::detach(view::slot_handle const& handle) {
+      node* const node = this->nodes.get(handle);
+      if ((node == NULL) || (--node->references > 0))
+        return;
 
-        std::string splitted = std::string(split_ranges[0].begin(), split_ranges[std::min(this->token_count, split_ranges.size()) - 1].end());
-        if (splitted != this->separator)
-          splitted += this->separator + "*";
+      this->trie.release(node->leaf);
+      this->node_handles.erase(node->string);
+      this->nodes.erase(handle);
+    }
 
-        return splitted;
-      } else {
-        return string;
-      }
+    glm::vec2 const& string_list::get_position(view::slot_handle const& handle) const {
+      node const* const node = this->nodes.get(handle);
+      if (node == NULL)
+        return this->bottom.position;
+
+      return node->position;
     }
 
-    size_t string_list::token_limit() {
-      return this->token_count;
+    view::string const* string_list::get_view(view::slot_handle const& handle) const {
+      node const* const node = this->nodes.get(handle);
+      if (node == NULL)
+        return NULL;
+
+      return node->view;
     }
 
-    void string_list::set_token_limit(size_t const token_count) {
-      this->token_count = token_count;
-      this->items.clear();
+    void string_list::resolve_nodes() {
+      for (auto& node : this->nodes) {
+        auto const it = this->views.find(node.name);
+        node.view = (it == this->views.end()) ? NULL : &it->second;
+      }
     }
 
-    void string_list::make_view(std::string const& string) {
-      std::string const& view_name = this->split(string);
-      auto               result    = this->views.insert(std::make_pair(view_name, view::string(view_name, this->alignment)));
+    void string_list::update_nodes() {
+      for (auto& node : this->nodes) {
+        if (node.view == NULL) {
+          node.position = this->bottom.position;
+          continue;
+        }
 
-      if (!result.second)
-        return;
+        node.position = node.view->position;
+        switch (this->alignment) {
+          case view::alignment::left:
+            node.position.x += node.view->dimension.x;
+            break;
+
+          case view::alignment::right:
+            node.position.x -= node.view->dimension.x;
+            break;
+
+          default:
+            break;
+        }
+      }
+    }
+
+    std::string const& string_list::make_view(std::string const& view_name) {
+      auto const existing = this->views.find(view_name);
+      if (existing != this->views.end())
+        return existing->first;
+
+      auto const result = this->views.insert(std::make_pair(view_name, view::string(view_name, this->alignment)));
 
       auto const& it = result.first;
 
@@ -72,65 +136,159 @@ namespace logoprism {
       view::string const& next = (std::next(it) == this->views.end()) ? this->bottom : std::next(it)->second;
 
       it->second.position = (prev.position + next.position) / 2.0f;
+
+      return it->first;
     }
 
-    glm::vec2 string_list::get_position(std::string const& string) {
-      std::string const& view_name = this->split(string);
-      auto const         it        = this->views.find(view_name);
+    string_list::layout_t string_list::layout() {
+      layout_t layout;
 
-      if (it == this->views.end())
-        return this->bottom.position;
+      for (auto& pair : this->views) {
+        if (!pair.second.is_dying())
+          layout.insert(std::make_pair(pair.first, pair.second.position));
+      }
 
-      glm::vec2        position  = it->second.position;
-      glm::vec2 const& dimension = it->second.dimension;
+      return layout;
+    }
 
-      switch (this->alignment) {
-        case view::alignment::left:
-          position.x += dimension.x;
-          break;
+    void string_list::restore(layout_t const& layout) {
+      this->solver.clear();
+      this->views.clear();
+      for (auto const& node : this->nodes) {
+        this->trie.release(node.leaf);
+      }
+      this->nodes.clear();
+      this->node_handles.clear();
 
-        case view::alignment::right:
-          position.x -= dimension.x;
-          break;
+      for (auto const& pair : layout) {
+        view::string& view = this->views.insert(std::make_pair(pair.first, view::string(pair.first, this->alignment))).first->second;
+        view.position = pair.second;
+      }
+    }
 
-        default:
-          break;
+    void string_list::set_items(items_t const& items) {
+      // hold the new strings in the trie, and release the previous ones, so that the trie follows the items
+      std::vector< uint32_t > leaves;
+      leaves.reserve(items.size());
+      for (auto const item : items) {
+        leaves.push_back(this->trie.acquire(*item));
+      }
+      for (auto const leaf : this->item_leaves) {
+        this->trie.release(leaf);
       }
+      this->item_leaves.swap(leaves);
 
-      return position;
+      // sort the view names of the items, referencing the keys of their views rather than copying them
+      items_t names(items.get_allocator());
+      names.reserve(items.size());
+
+      for (auto const leaf : this->item_leaves) {
+        names.push_back(&this->make_view(this->trie.label(leaf, this->token_count)));
+      }
+
+      std::sort(names.begin(), names.end(), [](std::string const* a, std::string const* b) { return *a < *b; });
+
+      // both the names and the views are sorted, kill the views whose name is not in the items
+      auto name = names.begin();
+      for (auto& pair : this->views) {
+        while ((name != names.end()) && (**name < pair.first))
+          ++name;
+
+        if ((name == names.end()) || (**name != pair.first))
+          pair.second.kill();
+      }
     }
 
     void string_list::logic(data::timings const& timings) {
       if (timings.is_keyframe) {
-        std::set< std::string > splitted_items;
-        std::transform(std::begin(this->items), std::end(this->items), std::inserter(splitted_items, std::end(splitted_items)),
-                       [=](std::string const& s) { this->make_view(s); return this->split(s); });
-
         for (auto it = std::begin(this->views), end = std::end(this->views); it != end;) {
-          if (splitted_items.find(it->first) == splitted_items.end())
-            it->second.kill();
-
           if (it->second.is_dead())
             this->views.erase(it++);
           else
             ++it;
         }
 
+        this->resolve_nodes();
         this->refresh_bonds();
       }
 
       for (auto& pair : this->views) {
         pair.second.logic(timings);
       }
-      for (auto& bond : this->bonds) {
-        bond.logic(timings);
-      }
+      this->solver.step(view::layout_solver::factor(timings));
+
+      this->update_nodes();
     } // logic
 
     void string_list::draw(renderer::base& renderer, data::timings const& timings) {
+      text::anchor const anchor      = view::string::anchor(this->alignment);
+      float const        line_height = std::max(1.0f, renderer.measure("+0 more", anchor, view::string::font()).y);
+      float const        low         = std::min(this->top.position.y, this->bottom.position.y) - line_height / 2.0f;
+      float const        high        = std::max(this->top.position.y, this->bottom.position.y) + line_height / 2.0f;
+
+      // cull the labels out of the column, and sort the others from top to bottom
+      std::vector< view::string*, utils::arena_allocator< view::string* > > labels(utils::arena::frame());
+      labels.reserve(this->views.size());
+
+      // the labels that are not drawn still need their dimension, as the request curves are anchored at their end, but they
+      // are only measured once
       for (auto& pair : this->views) {
-        pair.second.draw(renderer, timings);
+        if (pair.second.is_dead())
+          continue;
+
+        if ((pair.second.position.y < low) || (pair.second.position.y > high)) {
+          pair.second.measure(renderer);
+          continue;
+        }
+
+        labels.push_back(&pair.second);
+      }
+
+      std::stable_sort(labels.begin(), labels.end(), [](view::string const* a, view::string const* b) { return a->position.y < b->position.y; });
+
+      // greedily keep the labels that do not overlap the previous one, the overlapping ones are merged in a summary label,
+      // placed on the first free line after them, or in place of the next readable label if there is no room for it
+      float  free_line = -std::numeric_limits< float >::infinity();
+      size_t hidden    = 0;
+
+      for (auto const label : labels) {
+        float const top_line = label->position.y - line_height / 2.0f;
+
+        if (top_line < free_line) {
+          label->measure(renderer);
+          hidden += 1;
+          continue;
+        }
+
+        if ((hidden > 0) && (top_line < free_line + line_height)) {
+          label->measure(renderer);
+          this->draw_summary(renderer, glm::vec2(label->position.x, label->position.y), anchor, hidden + 1);
+          hidden    = 0;
+          free_line = top_line + line_height;
+          continue;
+        }
+
+        if (hidden > 0) {
+          this->draw_summary(renderer, glm::vec2(label->position.x, free_line + line_height / 2.0f), anchor, hidden);
+          hidden = 0;
+        }
+
+        label->draw(renderer, timings);
+        free_line = top_line + line_height;
       }
+
+      if (hidden > 0)
+        this->draw_summary(renderer, glm::vec2(this->bottom.position.x, std::min(free_line, high - line_height) + line_height / 2.0f), anchor, hidden);
+    } // draw
+
+    void string_list::draw_summary(renderer::base& renderer, glm::vec2 const& position, text::anchor const anchor, size_t const count) {
+      static glm::vec4 const summary_color = glm::vec4(1.0, 1.0, 1.0, 0.6);
+
+      this->summary_buffer.assign("+");
+      this->summary_buffer.append(std::to_string(count));
+      this->summary_buffer.append(" more");
+
+      renderer.render(this->summary_buffer, position, anchor, view::string::font(), summary_color);
     }
 
   }
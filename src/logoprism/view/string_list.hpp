@@ -2,9 +2,13 @@
 #define __LOGOPRISM_VIEW_STRING_LIST_HPP__
 
 #include "logoprism/view/string.hpp"
-#include "logoprism/view/bond.hpp"
+#include "logoprism/view/layout_solver.hpp"
+#include "logoprism/view/slot_map.hpp"
+#include "logoprism/view/token_trie.hpp"
+#include "logoprism/utils/arena.hpp"
 
 #include <set>
+#include <unordered_map>
 
 namespace logoprism {
   namespace view {
@@ -14,15 +18,45 @@ namespace logoprism {
         typedef std::map< std::string, view::string > view_map_t;
 
       public:
+        /** positions of the living string views, by name */
+        typedef std::map< std::string, glm::vec2 > layout_t;
+
+        /** the strings to show at a keyframe, allocated from the frame arena */
+        typedef std::vector< std::string const*, utils::arena_allocator< std::string const* > > items_t;
+
         string_list(glm::vec2 const& top, glm::vec2 const& bottom, std::string const& separator, view::alignment const alignment=view::alignment::left);
 
-        std::set< std::string >& get_items() { return this->items; }
-        void                     clear() { this->items.clear(); }
+        /** creates the views for the given strings, and kills the views of any other string, at a keyframe */
+        void set_items(items_t const& items);
 
         void logic(data::timings const& timings);
+
+        /**
+         * Draws the string views, skipping the ones out of the column, and merging the ones that would overlap a previous
+         * label into a "+N more" summary label, so that the number of labels drawn is bounded by the column height.
+         */
         void draw(renderer::base& renderer, data::timings const& timings);
 
-        glm::vec2 get_position(std::string const& string);
+        /**
+         * Gets a stable handle to the node of the given string, creating it if needed. The string is only split once per
+         * distinct string, and the node position is updated once per frame.
+         */
+        view::slot_handle attach(std::string const& string);
+
+        /** releases a node handle, the node is discarded once no handle refers to it anymore */
+        void detach(view::slot_handle const& node);
+
+        /** get the position of the node, or the bottom position if its string view does not exist */
+        glm::vec2 const& get_position(view::slot_handle const& node) const;
+
+        /** get the string view the node is displayed as, or NULL if it does not exist */
+        view::string const* get_view(view::slot_handle const& node) const;
+
+        /** get the current layout of the string views */
+        layout_t layout();
+
+        /** replaces the string views with the ones from the given layout */
+        void restore(layout_t const& layout);
 
         void refresh_bonds();
 
@@ -37,13 +71,37 @@ namespace logoprism {
         size_t          token_count;
 
       protected:
-        view_map_t              views;
-        std::set< std::string > items;
+        /** a string attached by some views, with its split view name and its position */
+        struct node {
+          node(std::string const& string, uint32_t const leaf, std::string const& name) : string(string), leaf(leaf), name(name), view(NULL), position(), references(1) {}
+
+          std::string   string;
+          uint32_t      leaf;
+          std::string   name;
+          view::string* view;
+          glm::vec2     position;
+          size_t        references;
+        };
+
+        view_map_t views;
+
+        view::layout_solver solver;
+
+        view::token_trie trie;
+
+        /** the strings of the current items, held in the trie until the next items replace them */
+        std::vector< uint32_t > item_leaves;
+
+        view::slot_map< node >                               nodes;
+        std::unordered_map< std::string, view::slot_handle > node_handles;
 
-        std::vector< view::bond > bonds;
+        /** reused buffer for the summary label text */
+        std::string summary_buffer;
 
-        void        make_view(std::string const& string);
-        std::string split(std::string const& string);
+        void               draw_summary(renderer::base& renderer, glm::vec2 const& position, text::anchor const anchor, size_t const count);
+        std::string const& make_view(std::string const& view_name);
+        void               resolve_nodes();
+        void               update_nodes();
     };
 
   }
@@ -0,0 +1,126 @@
+#include "logoprism/view/token_trie.hpp"
+
+#include <boost/algorithm/string.hpp>
+
+namespace logoprism {
+  namespace view {
+
+    token_trie::token_trie(std::string const& separator) :
+      separator(separator) {
+      node root = { 0, 0, std::string(), std::string(), 0 };
+      this->nodes.push_back(root);
+    }
+
+    uint32_t token_trie::acquire(std::string const& string) {
+      auto const it = this->leaf_index.find(string);
+      if (it != this->leaf_index.end()) {
+        this->leaves[it->second].references += 1;
+        return it->second;
+      }
+
+      leaf const leaf = { string, this->insert(string), 1 };
+
+      uint32_t index;
+      if (this->free_leaves.empty()) {
+        index = static_cast< uint32_t >(this->leaves.size());
+        this->leaves.push_back(leaf);
+      } else {
+        index = this->free_leaves.back();
+        this->free_leaves.pop_back();
+        this->leaves[index] = leaf;
+      }
+      this->leaf_index.insert(std::make_pair(string, index));
+
+      return index;
+    }
+
+    void token_trie::release(uint32_t const index) {
+      leaf& leaf = this->leaves[index];
+      if (--leaf.references > 0)
+        return;
+
+      // remove the string from every node on its path, and the nodes no other string goes through
+      for (uint32_t current = leaf.node; current != 0;) {
+        node& node = this->nodes[current];
+        uint32_t const parent = node.parent;
+
+        if (--node.count == 0) {
+          this->children.erase(std::make_pair(parent, node.token));
+          node.token.clear();
+          node.label.clear();
+          this->free_nodes.push_back(current);
+        }
+
+        current = parent;
+      }
+
+      this->leaf_index.erase(leaf.string);
+      leaf.string.clear();
+      this->free_leaves.push_back(index);
+    }
+
+    uint32_t token_trie::insert(std::string const& string) {
+      std::vector< boost::iterator_range< std::string::const_iterator > > split_ranges;
+      boost::split(split_ranges, string, boost::is_any_of(this->separator), boost::token_compress_on);
+
+      // walk down the trie, creating the missing nodes, each node being keyed by the characters of its token and of the
+      // separators preceding it, so that its label is exactly the prefix of the string
+      uint32_t current = 0;
+      size_t   begin   = 0;
+      for (auto const& range : split_ranges) {
+        size_t const end = range.end() - string.begin();
+
+        auto const key   = std::make_pair(current, string.substr(begin, end - begin));
+        auto const child = this->children.find(key);
+        if (child != this->children.end()) {
+          current = child->second;
+        } else {
+          node node = { current, this->nodes[current].depth + 1, key.second, string.substr(0, end), 0 };
+          if (node.label != this->separator)
+            node.label += this->separator + "*";
+
+          uint32_t index;
+          if (this->free_nodes.empty()) {
+            index = static_cast< uint32_t >(this->nodes.size());
+            this->nodes.push_back(node);
+          } else {
+            index = this->free_nodes.back();
+            this->free_nodes.pop_back();
+            this->nodes[index] = node;
+          }
+
+          current = index;
+          this->children.insert(std::make_pair(key, current));
+        }
+
+        this->nodes[current].count += 1;
+        begin = end;
+      }
+
+      return current;
+    } // insert
+
+    uint32_t token_trie::ancestor(uint32_t node, size_t const depth) const {
+      // strings with less tokens than the depth are collapsed in their leaf
+      while (this->nodes[node].depth > depth)
+        node = this->nodes[node].parent;
+
+      return node;
+    }
+
+    std::string token_trie::label(uint32_t const leaf, size_t const depth) const {
+      if (depth == 0)
+        return this->leaves[leaf].string;
+
+      return this->nodes[this->ancestor(this->leaves[leaf].node, depth)].label;
+    }
+
+    size_t token_trie::count(uint32_t const leaf, size_t const depth) const {
+      if (depth == 0)
+        return 1;
+
+      return this->nodes[this->ancestor(this->leaves[leaf].node, depth)].count;
+    }
+
+  }
+}
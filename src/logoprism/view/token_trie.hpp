@@ -0,0 +1,85 @@
+#ifndef __LOGOPRISM_VIEW_TOKEN_TRIE_HPP__
+#define __LOGOPRISM_VIEW_TOKEN_TRIE_HPP__
+
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+namespace logoprism {
+  namespace view {
+
+    /**
+     * Trie of the separator-delimited tokens of strings, built incrementally as the strings are acquired. Each node holds
+     * the label of the strings collapsed at its depth, such as "10.0.*" for "10.0.1.2" and "10.0.3.4" at depth 2, and how
+     * many distinct strings it contains.
+     *
+     * Strings are split only once, when they are first acquired, and selecting an aggregation depth is a walk up the trie.
+     * The strings are reference counted, and a string and the nodes only it goes through are removed once released by
+     * every user, so that the trie only holds the strings still shown.
+     */
+    struct token_trie {
+      public:
+        /**
+         * Creates a new empty token trie.
+         * @param separator the characters delimiting the tokens
+         */
+        token_trie(std::string const& separator);
+
+        /**
+         * Acquires a reference to a string, inserting it if needed.
+         * @return the identifier of the string, stable until the string is released by every user
+         */
+        uint32_t acquire(std::string const& string);
+
+        /** releases a reference to a string, removing it once it is not referenced anymore */
+        void release(uint32_t const leaf);
+
+        /**
+         * Gets the label of a string collapsed at the given depth.
+         * @param  leaf  the identifier of the string
+         * @param  depth the number of tokens to keep, or 0 to keep the whole string
+         * @return       the label of the collapsed string
+         */
+        std::string label(uint32_t const leaf, size_t const depth) const;
+
+        /** the number of distinct strings collapsed with the given string at the given depth */
+        size_t count(uint32_t const leaf, size_t const depth) const;
+
+        /** the number of distinct strings referenced */
+        size_t size() const { return this->leaf_index.size(); }
+
+      protected:
+        struct node {
+          uint32_t    parent;
+          uint32_t    depth;
+          std::string token;
+          std::string label;
+          size_t      count;
+        };
+
+        struct leaf {
+          std::string string;
+          uint32_t    node;
+          size_t      references;
+        };
+
+        std::string const separator;
+
+        std::vector< node >                                      nodes;
+        std::vector< uint32_t >                                  free_nodes;
+        std::map< std::pair< uint32_t, std::string >, uint32_t > children;
+
+        std::vector< leaf >                         leaves;
+        std::vector< uint32_t >                     free_leaves;
+        std::unordered_map< std::string, uint32_t > leaf_index;
+
+        uint32_t insert(std::string const& string);
+        uint32_t ancestor(uint32_t node, size_t const depth) const;
+    };
+
+  }
+}
+
+#endif // ifndef __LOGOPRISM_VIEW_TOKEN_TRIE_HPP__